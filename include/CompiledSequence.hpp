@@ -0,0 +1,85 @@
+#ifndef COMPILED_SEQUENCE_HPP
+#define COMPILED_SEQUENCE_HPP
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include "MoveTables.hpp"
+#include "RubiksCube.hpp"
+
+class MoveSequence;
+
+/**
+ * @file CompiledSequence.hpp
+ * @brief Move sequences folded into a single reusable permutation
+ */
+
+/**
+ * @class CompiledSequence
+ * @brief A move sequence parsed and folded once into one MoveDef
+ * 
+ * Composing the move definitions of a sequence yields a single permutation
+ * with orientation changes that has the same effect as applying the moves
+ * one by one. Compiling costs one pass over the sequence; afterwards the
+ * sequence can be applied to any number of cubes or batches at the cost
+ * of a single move.
+ * 
+ * ## Usage
+ * ```
+ * const CompiledSequence tPerm("R U R' U' R' F R2 U' R' U' R U R' F'");
+ * cube.applySequence(tPerm);
+ * batch.applySequence(tPerm);
+ * ```
+ */
+class CompiledSequence {
+    MoveDef def;        ///< Composition of every move in the sequence
+    size_t moveCount;   ///< Number of moves folded into def
+
+public:
+    /**
+     * @brief Constructs the empty sequence (the identity permutation)
+     */
+    CompiledSequence();
+
+    /**
+     * @brief Parses and compiles a space-separated move string
+     * @param moves Moves in Singmaster notation, e.g. "R U R' U'"
+     * @throws std::invalid_argument if any move is not recognized
+     */
+    explicit CompiledSequence(const std::string& moves);
+
+    /**
+     * @brief Compiles a sequence of enumerated moves
+     * @param moves Moves in the order they are applied
+     */
+    explicit CompiledSequence(std::span<const RubiksCube::Move> moves);
+
+    /**
+     * @brief Compiles a packed move sequence
+     * @param moves Moves in the order they are applied
+     */
+    explicit CompiledSequence(const MoveSequence& moves);
+
+    /**
+     * @brief Returns the sequence followed by @p next
+     * @param next Sequence applied after this one
+     */
+    CompiledSequence then(const CompiledSequence& next) const;
+
+    /**
+     * @brief Returns the sequence that undoes this one
+     */
+    CompiledSequence inverse() const;
+
+    /**
+     * @brief Returns the folded permutation
+     */
+    const MoveDef& definition() const { return def; }
+
+    /**
+     * @brief Returns the number of moves the sequence was compiled from
+     */
+    size_t length() const { return moveCount; }
+};
+
+#endif
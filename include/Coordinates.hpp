@@ -0,0 +1,188 @@
+#ifndef COORDINATES_HPP
+#define COORDINATES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "CubeState.hpp"
+#include "TableStorage.hpp"
+
+/**
+ * @file Coordinates.hpp
+ * @brief Integer coordinates of cube states and their move tables
+ *
+ * A coordinate maps a cube state to a small integer that captures one
+ * aspect of it, such as the corner twists or the positions of the slice
+ * edges. Solvers search over coordinates instead of full states: a move
+ * table turns "apply move m" into one array lookup per coordinate, and a
+ * pruning table indexed by coordinates gives a lower bound on the
+ * remaining distance.
+ *
+ * The numbering follows Kociemba's two-phase algorithm, so every
+ * coordinate is 0 for the solved state.
+ */
+
+/// Corner orientation coordinate: 3^7 twist combinations
+inline constexpr size_t kTwistCount = 2187;
+
+/// Edge orientation coordinate: 2^11 flip combinations
+inline constexpr size_t kFlipCount = 2048;
+
+/// Positions of the four UD-slice edges, ignoring their order: C(12,4)
+inline constexpr size_t kSliceCount = 495;
+
+/// Positions and order of the four UD-slice edges: 12*11*10*9
+inline constexpr size_t kSliceSortedCount = 11880;
+
+/// Permutations of the 8 corners
+inline constexpr size_t kCornerPermCount = 40320;
+
+/// Permutations of the 8 U/D-layer edges (valid once the slice edges are home)
+inline constexpr size_t kUDEdgePermCount = 40320;
+
+/// Permutations of the 4 UD-slice edges among themselves
+inline constexpr size_t kSlicePermCount = 24;
+
+/// Number of moves, used as the row stride of every move table
+inline constexpr size_t kMoveCount = 18;
+
+/// Moves that keep a cube inside Kociemba's subgroup G1 = <U, D, R2, L2, F2, B2>
+inline constexpr RubiksCube::Move g_phase2Moves[10] = {
+    RubiksCube::Move::U, RubiksCube::Move::U_PRIME, RubiksCube::Move::U2,
+    RubiksCube::Move::D, RubiksCube::Move::D_PRIME, RubiksCube::Move::D2,
+    RubiksCube::Move::R2, RubiksCube::Move::L2, RubiksCube::Move::F2, RubiksCube::Move::B2
+};
+
+/// All 18 moves in enum order
+inline constexpr RubiksCube::Move g_allMoves[18] = {
+    RubiksCube::Move::U, RubiksCube::Move::U_PRIME, RubiksCube::Move::U2,
+    RubiksCube::Move::D, RubiksCube::Move::D_PRIME, RubiksCube::Move::D2,
+    RubiksCube::Move::R, RubiksCube::Move::R_PRIME, RubiksCube::Move::R2,
+    RubiksCube::Move::L, RubiksCube::Move::L_PRIME, RubiksCube::Move::L2,
+    RubiksCube::Move::F, RubiksCube::Move::F_PRIME, RubiksCube::Move::F2,
+    RubiksCube::Move::B, RubiksCube::Move::B_PRIME, RubiksCube::Move::B2
+};
+
+/// Face index standing for "no previous move" in canFollow
+inline constexpr int kNoFace = 6;
+
+/**
+ * @brief Checks whether a turn of @p face may follow a turn of @p prevFace
+ *
+ * Turning the same face twice in a row is never optimal, and turns of
+ * opposite faces commute, so searches only generate the order U before D,
+ * R before L and F before B. Faces are numbered in RubiksCube::Move order
+ * (move / 3).
+ */
+constexpr bool canFollow(int face, int prevFace) {
+    return face != prevFace && !(face / 2 == prevFace / 2 && face < prevFace);
+}
+
+/**
+ * @brief Corner twist coordinate (0-2186), base-3 digits of corners 0-6
+ */
+uint16_t twistCoord(const CubeState& s);
+
+/**
+ * @brief Edge flip coordinate (0-2047), base-2 digits of edges 0-10
+ */
+uint16_t flipCoord(const CubeState& s);
+
+/**
+ * @brief Position and order of the UD-slice edges FR, FL, BL, BR (0-11879)
+ *
+ * Divided by 24 it gives the unordered slice coordinate (0-494), which is 0
+ * exactly when all four slice edges are in the slice. Modulo 24 it gives
+ * their order, which is the phase-2 slice permutation once they are home.
+ */
+uint16_t sliceSortedCoord(const CubeState& s);
+
+/**
+ * @brief Unordered slice coordinate (0-494), sliceSortedCoord / 24
+ */
+uint16_t sliceCoord(const CubeState& s);
+
+/**
+ * @brief Order of the slice edges (0-23), sliceSortedCoord % 24
+ */
+uint16_t slicePermCoord(const CubeState& s);
+
+/**
+ * @brief Corner permutation coordinate (0-40319)
+ */
+uint16_t cornerPermCoord(const CubeState& s);
+
+/**
+ * @brief Permutation coordinate of edges 0-7 (0-40319)
+ *
+ * Only meaningful when the slice edges occupy slots 8-11.
+ */
+uint16_t udEdgePermCoord(const CubeState& s);
+
+/**
+ * @brief Move table of one coordinate
+ *
+ * Entry `coord * kMoveCount + move` holds the coordinate after the move.
+ * Tables built for a subset of moves hold kInvalid for the others.
+ */
+class CoordMoveTable {
+    TableStorage<uint16_t> next; ///< Row-major [coordinate][move] successors
+
+public:
+    /// Successor stored for moves the table was not built for
+    static constexpr uint16_t kInvalid = 0xFFFF;
+
+    CoordMoveTable() = default;
+
+    /**
+     * @brief Wraps existing successors, e.g. loaded from a table file
+     */
+    explicit CoordMoveTable(TableStorage<uint16_t> next) : next(std::move(next)) {}
+
+    /**
+     * @brief Builds a move table by breadth-first search from the solved state
+     * @param size Number of coordinate values
+     * @param coordOf Maps a CubeState to its coordinate
+     * @param moves Moves to tabulate; together they must reach all @p size values
+     * @throws std::logic_error if some coordinate value is never reached
+     *
+     * One representative state is kept per coordinate value and every move
+     * is applied to it through the shared move definitions, so the tables
+     * can never disagree with RubiksCube. This relies on the coordinate
+     * after a move depending only on the coordinate before it.
+     */
+    static CoordMoveTable build(size_t size, uint16_t (*coordOf)(const CubeState&),
+                                std::span<const RubiksCube::Move> moves);
+
+    /**
+     * @brief Returns the coordinate reached by applying @p move
+     */
+    uint16_t operator()(size_t coord, RubiksCube::Move move) const {
+        return next[coord * kMoveCount + static_cast<size_t>(move)];
+    }
+
+    /**
+     * @brief Returns the coordinate reached by applying the move with enum value @p move
+     */
+    uint16_t operator()(size_t coord, size_t move) const {
+        return next[coord * kMoveCount + move];
+    }
+
+    /**
+     * @brief Returns the number of coordinate values
+     */
+    size_t size() const { return next.size() / kMoveCount; }
+
+    /**
+     * @brief Returns the table's memory footprint in bytes
+     */
+    size_t bytes() const { return next.bytes(); }
+
+    /**
+     * @brief Returns the successor array, for writing to a table file
+     */
+    const TableStorage<uint16_t>& storage() const { return next; }
+};
+
+#endif
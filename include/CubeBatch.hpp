@@ -0,0 +1,114 @@
+#ifndef CUBE_BATCH_HPP
+#define CUBE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "RubiksCube.hpp"
+
+class CompiledSequence;
+
+/**
+ * @file CubeBatch.hpp
+ * @brief Structure-of-arrays container for applying moves to many cubes at once
+ */
+
+/**
+ * @class CubeBatch
+ * @brief Stores N cube states in a SIMD-friendly structure-of-arrays layout
+ *
+ * The batch holds 20 rows, one per cubie slot (corners 0-7, then edges 0-11).
+ * Row r contains the packed byte `piece | (orientation << 4)` of slot r for
+ * every cube, so consecutive bytes belong to consecutive cubes. Rows are
+ * padded to a multiple of 32 lanes; padding lanes are never read back.
+ *
+ * With this layout a move never shuffles bytes inside a register: it selects
+ * which rows to read and adds an orientation delta, so one AVX2 instruction
+ * processes 32 cubes. Without AVX2 the same-move kernel is written as
+ * fixed-width byte loops that the compiler vectorizes with SSE2, and per-cube
+ * moves fall back to a lane-by-lane scalar loop.
+ *
+ * ## Usage
+ * ```
+ * CubeBatch batch(1'000'000);
+ * batch.applyMove(RubiksCube::Move::R);   // same move on every cube
+ * batch.applyMoves(perCubeMoves);         // perCubeMoves[i] applied to cube i
+ * RubiksCube first = batch.get(0);
+ * ```
+ */
+class CubeBatch {
+    size_t count;               ///< Number of cubes in the batch
+    size_t stride;              ///< Row length in bytes (count rounded up to whole chunks)
+    std::vector<uint8_t> rows;  ///< 20 rows of `stride` packed cubie bytes
+
+public:
+    /// Number of cubie rows (8 corners followed by 12 edges)
+    static constexpr size_t kRows = 20;
+
+    /// Cubes processed per SIMD chunk
+    static constexpr size_t kLanes = 32;
+
+    /**
+     * @brief Constructs a batch of cubes, all in the solved state
+     * @param count Number of cubes
+     */
+    explicit CubeBatch(size_t count);
+
+    /**
+     * @brief Builds a batch holding copies of the given cubes
+     * @param cubes Source cubes; lane i holds cubes[i]
+     */
+    static CubeBatch fromCubes(std::span<const RubiksCube> cubes);
+
+    /**
+     * @brief Returns the number of cubes in the batch
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Resets every cube to the solved state
+     */
+    void reset();
+
+    /**
+     * @brief Stores a cube state into one lane
+     * @param lane Lane index (< size())
+     * @param cube State to store
+     */
+    void set(size_t lane, const RubiksCube& cube);
+
+    /**
+     * @brief Reads the cube state of one lane
+     * @param lane Lane index (< size())
+     * @return Cube with the same pieces and orientations
+     */
+    RubiksCube get(size_t lane) const;
+
+    /**
+     * @brief Checks whether the cube in one lane is solved
+     * @param lane Lane index (< size())
+     */
+    bool isSolved(size_t lane) const;
+
+    /**
+     * @brief Applies the same move to every cube in the batch
+     * @param move Enumerated move value
+     */
+    void applyMove(RubiksCube::Move move);
+
+    /**
+     * @brief Applies a different move to each cube
+     * @param moves One move per lane; moves[i] is applied to cube i
+     * @throws std::invalid_argument if moves.size() != size()
+     */
+    void applyMoves(std::span<const RubiksCube::Move> moves);
+
+    /**
+     * @brief Applies a precompiled move sequence to every cube in one pass
+     * @param sequence Sequence folded into one permutation by CompiledSequence
+     */
+    void applySequence(const CompiledSequence& sequence);
+};
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef CUBE_STATE_HPP
+#define CUBE_STATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include "MoveTables.hpp"
+#include "RubiksCube.hpp"
+
+/**
+ * @file CubeState.hpp
+ * @brief Trivially copyable cube value type for search nodes and tables
+ */
+
+/**
+ * @struct CubeState
+ * @brief Plain 20-byte cube state usable in constant expressions
+ *
+ * Each slot holds one byte `piece | (orientation << 4)`, the same encoding
+ * used by PackedCube and CubeBatch. Slot numbering follows RubiksCube.
+ *
+ * The type has no constructors, destructor or virtual functions, so it can be
+ * copied with memcpy, stored in flat arrays and hash tables, and written to
+ * memory-mapped files as is. A default-initialized CubeState is not a valid
+ * cube; start from CubeState::solved() or fromCube().
+ *
+ * ## Usage
+ * ```
+ * CubeState s = CubeState::solved();
+ * s.applyMove(RubiksCube::Move::R);
+ * std::unordered_set<CubeState> seen{s};
+ * ```
+ */
+struct CubeState {
+    std::array<uint8_t, 8> corners;  ///< Packed corner slots 0-7
+    std::array<uint8_t, 12> edges;   ///< Packed edge slots 0-11
+
+    /**
+     * @brief Returns the solved state
+     */
+    static constexpr CubeState solved() {
+        CubeState s{};
+        s.reset();
+        return s;
+    }
+
+    /**
+     * @brief Resets the state to solved
+     */
+    constexpr void reset() {
+        for (uint8_t i = 0; i < 8; ++i) corners[i] = i;
+        for (uint8_t i = 0; i < 12; ++i) edges[i] = i;
+    }
+
+    /**
+     * @brief Checks whether every slot holds its own piece unrotated
+     */
+    constexpr bool isSolved() const {
+        for (uint8_t i = 0; i < 8; ++i) {
+            if (corners[i] != i) return false;
+        }
+        for (uint8_t i = 0; i < 12; ++i) {
+            if (edges[i] != i) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Applies an arbitrary permutation with orientation changes
+     * @param def Move definition, e.g. from g_moveTables or CompiledSequence
+     */
+    constexpr void apply(const MoveDef& def) {
+        std::array<uint8_t, 8> c{};
+        for (int i = 0; i < 8; ++i) {
+            const uint8_t from = corners[def.corner_perm[i]];
+            const int ori = ((from >> 4) + def.corner_ori_delta[i]) % 3;
+            c[i] = (uint8_t)((from & 0x0F) | (ori << 4));
+        }
+        std::array<uint8_t, 12> e{};
+        for (int i = 0; i < 12; ++i) {
+            const uint8_t from = edges[def.edge_perm[i]];
+            e[i] = (uint8_t)(from ^ (def.edge_ori_delta[i] << 4));
+        }
+        corners = c;
+        edges = e;
+    }
+
+    /**
+     * @brief Applies a single face turn
+     * @param move Enumerated move value
+     */
+    constexpr void applyMove(RubiksCube::Move move) {
+        apply(g_moveTables[static_cast<size_t>(move)]);
+    }
+
+    /**
+     * @brief Returns a copy of this state with @p move applied
+     */
+    constexpr CubeState moved(RubiksCube::Move move) const {
+        CubeState s = *this;
+        s.applyMove(move);
+        return s;
+    }
+
+    /**
+     * @brief Returns the inverse state, whose moves undo this one
+     *
+     * Solving the inverse and inverting the solution solves this state with
+     * the same number of moves.
+     */
+    constexpr CubeState inverse() const {
+        CubeState r{};
+        for (int i = 0; i < 8; ++i) {
+            r.corners[cornerPiece(i)] = (uint8_t)(i | (((3 - cornerOrientation(i)) % 3) << 4));
+        }
+        for (int i = 0; i < 12; ++i) {
+            r.edges[edgePiece(i)] = (uint8_t)(i | (edgeOrientation(i) << 4));
+        }
+        return r;
+    }
+
+    /**
+     * @brief Returns the piece in a corner slot (0-7)
+     */
+    constexpr uint8_t cornerPiece(int slot) const { return corners[slot] & 0x0F; }
+
+    /**
+     * @brief Returns the twist of a corner slot (0-2)
+     */
+    constexpr uint8_t cornerOrientation(int slot) const { return corners[slot] >> 4; }
+
+    /**
+     * @brief Returns the piece in an edge slot (0-11)
+     */
+    constexpr uint8_t edgePiece(int slot) const { return edges[slot] & 0x0F; }
+
+    /**
+     * @brief Returns the flip of an edge slot (0-1)
+     */
+    constexpr uint8_t edgeOrientation(int slot) const { return edges[slot] >> 4; }
+
+    /**
+     * @brief Returns a 64-bit hash of the state
+     *
+     * The 20 bytes are folded into three words and mixed with the
+     * splitmix64 finalizer, which is cheap and spreads single-byte changes
+     * across all output bits.
+     */
+    constexpr uint64_t hash() const {
+        auto mix = [](uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        uint64_t c = 0, e0 = 0, e1 = 0;
+        for (int i = 0; i < 8; ++i) c |= (uint64_t)corners[i] << (8 * i);
+        for (int i = 0; i < 8; ++i) e0 |= (uint64_t)edges[i] << (8 * i);
+        for (int i = 0; i < 4; ++i) e1 |= (uint64_t)edges[8 + i] << (8 * i);
+        return mix(mix(mix(c) ^ e0) ^ e1);
+    }
+
+    friend constexpr bool operator==(const CubeState&, const CubeState&) = default;
+
+    /**
+     * @brief Converts a RubiksCube into a CubeState
+     */
+    static CubeState fromCube(const RubiksCube& cube) {
+        CubeState s{};
+        for (int i = 0; i < 8; ++i) {
+            s.corners[i] = (uint8_t)(cube.cornerPiece(i) | (cube.cornerOrientation(i) << 4));
+        }
+        for (int i = 0; i < 12; ++i) {
+            s.edges[i] = (uint8_t)(cube.edgePiece(i) | (cube.edgeOrientation(i) << 4));
+        }
+        return s;
+    }
+
+    /**
+     * @brief Converts this state back into a RubiksCube
+     */
+    RubiksCube toCube() const {
+        RubiksCube cube;
+        for (int i = 0; i < 8; ++i) cube.setCorner(i, cornerPiece(i), cornerOrientation(i));
+        for (int i = 0; i < 12; ++i) cube.setEdge(i, edgePiece(i), edgeOrientation(i));
+        return cube;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<CubeState>, "CubeState must stay trivially copyable");
+static_assert(std::is_standard_layout_v<CubeState>, "CubeState must stay standard layout");
+static_assert(sizeof(CubeState) == 20, "CubeState must stay 20 bytes");
+
+/**
+ * @brief Hash support so CubeState can key unordered containers
+ */
+template <>
+struct std::hash<CubeState> {
+    size_t operator()(const CubeState& s) const noexcept { return (size_t)s.hash(); }
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef FACELETS_HPP
+#define FACELETS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include "Color.hpp"
+#include "CubeState.hpp"
+
+/**
+ * @file Facelets.hpp
+ * @brief Conversion between facelet strings and cubie states, with validation
+ *
+ * A facelet string lists the 54 stickers face by face in the order
+ * U, R, F, D, L, B. Each face is read row by row as seen from the outside,
+ * with U viewed with B at the top, D with F at the top, and the side faces
+ * with U at the top:
+ * ```
+ *              |  0  1  2 |
+ *              |  3  4  5 |
+ *              |  6  7  8 |
+ *   | 36 37 38 | 18 19 20 |  9 10 11 | 45 46 47 |
+ *   | 39 40 41 | 21 22 23 | 12 13 14 | 48 49 50 |
+ *   | 42 43 44 | 24 25 26 | 15 16 17 | 51 52 53 |
+ *              | 27 28 29 |
+ *              | 30 31 32 |
+ *              | 33 34 35 |
+ * ```
+ * Stickers are Color letters. The centre stickers decide which colour
+ * belongs to which face, so any colour scheme is accepted on input; output
+ * uses U=W, R=R, F=G, D=Y, L=O, B=B.
+ */
+
+/// Number of stickers in a facelet string
+inline constexpr size_t kFaceletCount = 54;
+
+/**
+ * @brief Reasons a facelet string or cubie state can be rejected
+ */
+enum class StateError {
+    None,             ///< The state is a reachable cube
+    InvalidLength,    ///< Facelet text is not 54 characters
+    InvalidColor,     ///< A sticker is not a Color letter used by a centre
+    InvalidCenter,    ///< Centres are not six distinct Color letters
+    InvalidCorner,    ///< A corner's sticker colours match no corner piece
+    InvalidEdge,      ///< An edge's sticker colours match no edge piece
+    DuplicateCorner,  ///< A corner piece is missing or appears twice
+    DuplicateEdge,    ///< An edge piece is missing or appears twice
+    TwistError,       ///< Corner twists do not sum to a multiple of 3
+    FlipError,        ///< Edge flips do not sum to a multiple of 2
+    ParityError       ///< Corner and edge permutation parities differ
+};
+
+/**
+ * @brief Returns a short human-readable description of a state error
+ */
+const char* stateErrorMessage(StateError error);
+
+/**
+ * @brief Checks that a cubie state can be reached from solved by face turns
+ * @param state State to check; pieces and orientations may hold any value
+ * @return StateError::None, or the first invariant that is violated
+ *
+ * Checks that every piece appears exactly once with an in-range
+ * orientation, that the twist and flip sums vanish, and that the corner
+ * and edge permutations have equal parity.
+ */
+StateError validateState(const CubeState& state);
+
+/**
+ * @brief Converts and validates one facelet string
+ * @param facelets 54 sticker letters in URFDLB order
+ * @param out Receives the state; left unspecified on error
+ * @return StateError::None on success
+ */
+StateError fromFacelets(std::string_view facelets, CubeState& out);
+
+/**
+ * @brief Writes the 54 stickers of a state in URFDLB order
+ * @param state Valid cubie state
+ * @param out Destination for exactly kFaceletCount characters (not NUL-terminated)
+ */
+void toFacelets(const CubeState& state, char* out);
+
+/**
+ * @brief Converts many fixed-width facelet records in one pass
+ * @param text Records back to back; record i starts at i * stride
+ * @param stride Distance between records, at least kFaceletCount
+ *               (e.g. 55 for newline-terminated lines)
+ * @param out Receives one state per record
+ * @param status Receives one error code per record; same size as out
+ * @return Number of records that converted to valid states
+ *
+ * Never throws. Records beyond the end of @p text are reported as
+ * StateError::InvalidLength.
+ */
+size_t fromFaceletsBulk(std::string_view text, size_t stride,
+                        std::span<CubeState> out, std::span<StateError> status);
+
+/**
+ * @brief Writes many states as fixed-width facelet records
+ * @param states States to write
+ * @param out Destination of at least states.size() * stride bytes
+ * @param stride Distance between records; bytes between the 54 stickers and
+ *               the next record are set to '\n'
+ */
+void toFaceletsBulk(std::span<const CubeState> states, char* out, size_t stride);
+
+#endif
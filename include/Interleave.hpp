@@ -0,0 +1,100 @@
+#ifndef INTERLEAVE_HPP
+#define INTERLEAVE_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <utility>
+
+/**
+ * @file Interleave.hpp
+ * @brief Many independent searches sharing one thread as C++20 coroutines
+ *
+ * A search that stalls on a cache miss leaves the core idle for hundreds of
+ * cycles. Written as a coroutine, it can instead prefetch the entries it is
+ * about to read and suspend; the worker resumes other searches meanwhile
+ * and comes back once the entries have had time to arrive. With a few
+ * dozen searches in flight, most misses overlap with useful work.
+ */
+
+/**
+ * @class InterleavedTask
+ * @brief Coroutine type of one interleaved search
+ *
+ * The coroutine starts suspended and runs only when resumed; it suspends
+ * itself with `co_await YieldToOthers{}` and finishes with `co_return`.
+ * An exception escaping the body is rethrown by the resume() that ran it.
+ */
+class InterleavedTask {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        InterleavedTask get_return_object() {
+            return InterleavedTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { this->error = std::current_exception(); }
+    };
+
+    InterleavedTask() = default;
+    InterleavedTask(InterleavedTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    InterleavedTask& operator=(InterleavedTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            this->handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    InterleavedTask(const InterleavedTask&) = delete;
+    InterleavedTask& operator=(const InterleavedTask&) = delete;
+    ~InterleavedTask() { reset(); }
+
+    /**
+     * @brief Checks whether the task holds a coroutine that has not finished
+     */
+    bool active() const { return this->handle && !this->handle.done(); }
+
+    /**
+     * @brief Runs the coroutine until it next suspends or finishes
+     * @throws Whatever the coroutine body threw
+     */
+    void resume() {
+        this->handle.resume();
+        if (this->handle.done() && this->handle.promise().error) std::rethrow_exception(this->handle.promise().error);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit InterleavedTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    void reset() {
+        if (this->handle) this->handle.destroy();
+        this->handle = {};
+    }
+};
+
+/**
+ * @brief Awaitable that suspends an interleaved search until its worker comes back to it
+ */
+struct YieldToOthers : std::suspend_always {};
+
+/**
+ * @brief Runs make(task) for every task in [0, count), several at a time per thread
+ * @param count Number of tasks
+ * @param workers Threads to use, including the calling thread
+ * @param width Coroutines each worker keeps in flight; 1 runs them one after another
+ * @param make Creates the coroutine of a task; called on the worker that will run it
+ * @throws The first exception a coroutine threw, after every worker has stopped
+ *
+ * Each worker resumes its coroutines round-robin. When one finishes, the
+ * worker starts the next unstarted task in its slot, so workers stay full
+ * until the tasks run out and a few slow tasks do not hold up the others.
+ */
+void runInterleaved(size_t count, unsigned workers, size_t width, const std::function<InterleavedTask(size_t task)>& make);
+
+#endif
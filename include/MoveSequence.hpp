@@ -0,0 +1,206 @@
+#ifndef MOVE_SEQUENCE_HPP
+#define MOVE_SEQUENCE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "RubiksCube.hpp"
+
+/**
+ * @file MoveSequence.hpp
+ * @brief Compact move sequences with an allocation-free parser and serializer
+ */
+
+/**
+ * @brief Reasons a move string can fail to parse
+ */
+enum class ParseError {
+    None,           ///< Parsing succeeded
+    InvalidFace,    ///< Token does not start with one of U, D, R, L, F, B
+    InvalidSuffix,  ///< Face letter followed by something other than ', 2 or whitespace
+    TooLong         ///< Sequence exceeds MoveSequence::kCapacity moves
+};
+
+/**
+ * @brief Outcome of parsing a move string
+ */
+struct ParseResult {
+    ParseError error = ParseError::None; ///< What went wrong, if anything
+    size_t position = 0;                 ///< Offset of the offending character in the input
+
+    explicit operator bool() const { return error == ParseError::None; }
+};
+
+/**
+ * @brief Returns a short human-readable description of a parse error
+ */
+const char* parseErrorMessage(ParseError error);
+
+/**
+ * @brief Parses whitespace-separated moves, calling @p onMove for each one
+ * @param text Moves in Singmaster notation, e.g. "R U R' U2"
+ * @param onMove Callable invoked as onMove(RubiksCube::Move) in input order.
+ *               It may return a ParseError; anything but ParseError::None
+ *               stops parsing and is reported at the position of that move.
+ * @return Status with the position of the first invalid character
+ *
+ * Works directly on the input view and never allocates. Parsing stops at
+ * the first error; moves before it have already been reported.
+ */
+template <typename F>
+ParseResult forEachMove(std::string_view text, F&& onMove) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+    auto faceIndex = [](char c) -> int {
+        switch (c) {
+            case 'U': return 0;
+            case 'D': return 1;
+            case 'R': return 2;
+            case 'L': return 3;
+            case 'F': return 4;
+            case 'B': return 5;
+            default: return -1;
+        }
+    };
+
+    size_t pos = 0;
+    while (true) {
+        while (pos < text.size() && isSpace(text[pos])) ++pos;
+        if (pos == text.size()) return {};
+
+        const size_t start = pos;
+        const int face = faceIndex(text[pos]);
+        if (face < 0) return {ParseError::InvalidFace, pos};
+        ++pos;
+
+        int variant = 0;  // 0 = clockwise, 1 = prime, 2 = double
+        if (pos < text.size() && !isSpace(text[pos])) {
+            if (text[pos] == '\'') variant = 1;
+            else if (text[pos] == '2') variant = 2;
+            else return {ParseError::InvalidSuffix, pos};
+            ++pos;
+            if (pos < text.size() && !isSpace(text[pos])) return {ParseError::InvalidSuffix, pos};
+        }
+        const auto move = static_cast<RubiksCube::Move>(3 * face + variant);
+        if constexpr (std::is_void_v<std::invoke_result_t<F&, RubiksCube::Move>>) {
+            onMove(move);
+        } else {
+            const ParseError error = onMove(move);
+            if (error != ParseError::None) return {error, start};
+        }
+    }
+}
+
+/**
+ * @class MoveSequence
+ * @brief Fixed-capacity move sequence packed at 5 bits per move
+ *
+ * Twelve moves fit into each 64-bit word, so the whole sequence lives inline
+ * in 136 bytes (128 of packed moves plus the padded count) and copying it
+ * never touches the heap. The capacity covers scrambles, solutions and
+ * typical reconstructions.
+ */
+class MoveSequence {
+public:
+    /// Bits used to store one move (18 moves need 5 bits)
+    static constexpr size_t kBitsPerMove = 5;
+
+    /// Moves stored per 64-bit word
+    static constexpr size_t kMovesPerWord = 64 / kBitsPerMove;
+
+    /// Maximum number of moves in a sequence
+    static constexpr size_t kCapacity = 16 * kMovesPerWord;
+
+private:
+    std::array<uint64_t, kCapacity / kMovesPerWord> words; ///< Packed moves, 12 per word
+    uint16_t count;                                        ///< Number of moves stored
+
+public:
+    /**
+     * @brief Constructs an empty sequence
+     */
+    MoveSequence() : words{}, count(0) {}
+
+    /**
+     * @brief Parses a move string into a sequence without allocating
+     * @param text Whitespace-separated moves in Singmaster notation
+     * @param out Receives the parsed moves (cleared first)
+     * @return Status with the position of the first invalid character
+     */
+    static ParseResult parse(std::string_view text, MoveSequence& out);
+
+    /**
+     * @brief Returns the number of moves in the sequence
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Checks whether the sequence has no moves
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Removes all moves
+     */
+    void clear() { words.fill(0); count = 0; }
+
+    /**
+     * @brief Appends a move
+     * @param move Move to append
+     * @return false if the sequence is already at capacity
+     */
+    bool push_back(RubiksCube::Move move) {
+        if (count == kCapacity) return false;
+        const size_t shift = (count % kMovesPerWord) * kBitsPerMove;
+        words[count / kMovesPerWord] |= (uint64_t)move << shift;
+        ++count;
+        return true;
+    }
+
+    /**
+     * @brief Returns the move at position @p i (< size())
+     */
+    RubiksCube::Move operator[](size_t i) const {
+        const size_t shift = (i % kMovesPerWord) * kBitsPerMove;
+        return static_cast<RubiksCube::Move>((words[i / kMovesPerWord] >> shift) & 0x1F);
+    }
+
+    /**
+     * @brief Returns the sequence that undoes this one
+     *
+     * Moves are reversed and each is replaced by its inverse.
+     */
+    MoveSequence inverse() const;
+
+    /**
+     * @brief Upper bound on the text length of a sequence of @p moves moves
+     */
+    static constexpr size_t maxTextLength(size_t moves) { return moves * 3; }
+
+    /**
+     * @brief Writes the sequence in Singmaster notation into a caller buffer
+     * @param buffer Destination; not NUL-terminated
+     * @param capacity Size of the destination in bytes
+     * @return Length of the full text. If it exceeds @p capacity, only the
+     *         first @p capacity bytes were written.
+     *
+     * Moves are separated by single spaces, e.g. "R U R' U2".
+     */
+    size_t write(char* buffer, size_t capacity) const;
+
+    /**
+     * @brief Returns the sequence in Singmaster notation
+     */
+    std::string toString() const;
+
+    bool operator==(const MoveSequence& other) const {
+        return count == other.count && words == other.words;
+    }
+    bool operator!=(const MoveSequence& other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(MoveSequence) <= 136, "MoveSequence is copied by value into every SolveResult");
+
+#endif
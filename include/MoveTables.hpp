@@ -0,0 +1,155 @@
+#ifndef MOVE_TABLES_HPP
+#define MOVE_TABLES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "RubiksCube.hpp"
+
+/**
+ * @file MoveTables.hpp
+ * @brief Compile-time move definitions shared by every cube representation
+ * 
+ * All 18 face turns are generated by constexpr functions and stored in
+ * constant-initialized tables. There is no runtime initialization step, so
+ * the tables can be read from any number of threads without synchronization.
+ */
+
+/**
+ * @brief Defines a move in terms of piece permutations and orientation changes
+ * 
+ * Each move is represented by how pieces are permuted and how their orientations
+ * change. For corners, orientation ranges 0-2; for edges, 0-1.
+ */
+struct MoveDef {
+    std::array<uint8_t, 8> corner_perm;      ///< Where each corner slot gets its piece from
+    std::array<uint8_t, 8> corner_ori_delta; ///< Orientation change for each corner (0-2)
+    std::array<uint8_t, 12> edge_perm;       ///< Where each edge slot gets its piece from  
+    std::array<uint8_t, 12> edge_ori_delta;  ///< Orientation change for each edge (0-1)
+};
+
+/**
+ * @brief Returns the move that leaves every piece in place
+ */
+constexpr MoveDef identityMove() {
+    MoveDef r{};
+    for (uint8_t i = 0; i < 8; ++i) r.corner_perm[i] = i;
+    for (uint8_t i = 0; i < 12; ++i) r.edge_perm[i] = i;
+    return r;
+}
+
+/**
+ * @brief Returns the move equivalent to applying @p a followed by @p b
+ * 
+ * Slot i receives the piece that @p b pulls from slot b.perm[i], which in turn
+ * is the piece @p a pulled into that slot; orientation deltas accumulate.
+ */
+constexpr MoveDef composeMoves(const MoveDef& a, const MoveDef& b) {
+    MoveDef r{};
+    for (int i = 0; i < 8; ++i) {
+        r.corner_perm[i] = a.corner_perm[b.corner_perm[i]];
+        r.corner_ori_delta[i] = (uint8_t)((a.corner_ori_delta[b.corner_perm[i]] + b.corner_ori_delta[i]) % 3);
+    }
+    for (int i = 0; i < 12; ++i) {
+        r.edge_perm[i] = a.edge_perm[b.edge_perm[i]];
+        r.edge_ori_delta[i] = (uint8_t)((a.edge_ori_delta[b.edge_perm[i]] + b.edge_ori_delta[i]) % 2);
+    }
+    return r;
+}
+
+/**
+ * @brief Returns the move that undoes @p a
+ */
+constexpr MoveDef inverseMove(const MoveDef& a) {
+    MoveDef r{};
+    for (uint8_t i = 0; i < 8; ++i) {
+        r.corner_perm[a.corner_perm[i]] = i;
+        r.corner_ori_delta[a.corner_perm[i]] = (uint8_t)((3 - a.corner_ori_delta[i]) % 3);
+    }
+    for (uint8_t i = 0; i < 12; ++i) {
+        r.edge_perm[a.edge_perm[i]] = i;
+        r.edge_ori_delta[a.edge_perm[i]] = a.edge_ori_delta[i];
+    }
+    return r;
+}
+
+/**
+ * @brief Compares two move definitions element by element
+ */
+constexpr bool sameMove(const MoveDef& a, const MoveDef& b) {
+    for (int i = 0; i < 8; ++i) {
+        if (a.corner_perm[i] != b.corner_perm[i] || a.corner_ori_delta[i] != b.corner_ori_delta[i]) return false;
+    }
+    for (int i = 0; i < 12; ++i) {
+        if (a.edge_perm[i] != b.edge_perm[i] || a.edge_ori_delta[i] != b.edge_ori_delta[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Builds the table of all 18 moves, indexed by RubiksCube::Move
+ * 
+ * Creates move definitions for:
+ * - 6 base moves (U, D, R, L, F, B) - clockwise quarter turns
+ * - 6 inverse moves (U', D', R', L', F', B') - counter-clockwise
+ * - 6 double moves (U2, D2, R2, L2, F2, B2) - 180-degree turns
+ * 
+ * Base moves are defined manually, inverse and double moves are derived
+ * by composing the base move with itself.
+ */
+constexpr std::array<MoveDef, 18> buildMoveTables() {
+    constexpr std::array<uint8_t, 8> c_zero{};   // All zeros for corner orientations
+    constexpr std::array<uint8_t, 12> e_zero{};  // All zeros for edge orientations
+
+    // Base quarter-turn moves (clockwise when viewing the face), in the
+    // face order of RubiksCube::Move. Each array shows where slot i gets its piece from.
+    const std::array<MoveDef, 6> base = {{
+        // U (Up) face: rotates top layer clockwise
+        { {3,0,1,2,4,5,6,7}, c_zero,
+          {3,0,1,2,4,5,6,7,8,9,10,11}, e_zero },
+        // D (Down) face: rotates bottom layer clockwise
+        { {0,1,2,3,5,6,7,4}, c_zero,
+          {0,1,2,3,5,6,7,4,8,9,10,11}, e_zero },
+        // R (Right) face: rotates right layer clockwise
+        { {4,1,2,0,7,5,6,3}, {2,0,0,1,1,0,0,2},
+          {8,1,2,3,11,5,6,7,4,9,10,0}, e_zero },
+        // L (Left) face: rotates left layer clockwise
+        { {0,2,6,3,4,1,5,7}, {0,1,2,0,0,2,1,0},
+          {0,1,10,3,4,5,9,7,8,2,6,11}, e_zero },
+        // F (Front) face: rotates front layer clockwise
+        { {1,5,2,3,0,4,6,7}, {1,2,0,0,2,1,0,0},
+          {0,9,2,3,4,8,6,7,1,5,10,11}, {0,1,0,0,0,1,0,0,1,1,0,0} },
+        // B (Back) face: rotates back layer clockwise
+        { {0,1,3,7,4,5,2,6}, {0,0,1,2,0,0,2,1},
+          {0,1,2,11,4,5,6,10,8,9,3,7}, {0,0,0,1,0,0,0,1,0,0,1,1} },
+    }};
+
+    // For each face: quarter turn, inverse (three quarter turns), double (two quarter turns)
+    std::array<MoveDef, 18> table{};
+    for (int f = 0; f < 6; ++f) {
+        const MoveDef twice = composeMoves(base[f], base[f]);
+        table[3 * f] = base[f];
+        table[3 * f + 1] = composeMoves(twice, base[f]);
+        table[3 * f + 2] = twice;
+    }
+    return table;
+}
+
+/// Move table indexed by RubiksCube::Move, constant-initialized at compile time
+inline constexpr std::array<MoveDef, 18> g_moveTables = buildMoveTables();
+
+/// Singmaster names indexed by RubiksCube::Move
+inline constexpr std::array<const char*, 18> g_moveNames = {
+    "U", "U'", "U2", "D", "D'", "D2",
+    "R", "R'", "R2", "L", "L'", "L2",
+    "F", "F'", "F2", "B", "B'", "B2"
+};
+
+/**
+ * @brief Returns the definition of an enumerated move
+ */
+constexpr const MoveDef& moveDefinition(RubiksCube::Move move) {
+    return g_moveTables[static_cast<size_t>(move)];
+}
+
+#endif
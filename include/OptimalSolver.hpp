@@ -0,0 +1,205 @@
+#ifndef OPTIMAL_SOLVER_HPP
+#define OPTIMAL_SOLVER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "Coordinates.hpp"
+#include "CubeState.hpp"
+#include "PruningTable.hpp"
+#include "SolveResult.hpp"
+#include "TableFile.hpp"
+#include "TranspositionTable.hpp"
+
+/**
+ * @file OptimalSolver.hpp
+ * @brief Korf-style optimal solver: IDA* with pattern databases
+ *
+ * The search deepens a cost bound one move at a time and prunes every
+ * node whose depth plus heuristic exceeds it, so the first solution found
+ * is optimal in the half-turn metric. The heuristic is the maximum of three
+ * pattern databases: one over all corners and two over disjoint groups of
+ * six edges.
+ */
+
+/// Ordered placements of 6 tracked edges in 12 slots: 12!/6!
+inline constexpr size_t kEdgeGroupPositions = 665280;
+
+/// Entries of one edge pattern database: placements times 2^6 flips
+inline constexpr size_t kEdgeGroupCount = kEdgeGroupPositions * 64;
+
+/// Entries of the corner pattern database: 8! permutations times 3^7 twists
+inline constexpr size_t kCornerPatternCount = kCornerPermCount * kTwistCount;
+
+/**
+ * @class OptimalTables
+ * @brief Pattern databases and move tables for the optimal search (about 220 MB)
+ *
+ * - Corner database: exact distance for every corner configuration,
+ *   indexed by `cornerPerm * 2187 + twist`.
+ * - Edge databases: exact distance for the placement and flips of edges
+ *   UR..DR (0-5) and of edges DF..BR (6-11), indexed by
+ *   `(placement << 6) | flips`.
+ *
+ * Both edge groups share one move table over placements. Each entry packs
+ * the new placement above six bits that say which tracked edges the move
+ * flips, so applying a move to an edge index is one lookup and one XOR.
+ *
+ * The databases are stored in TableBuildOptions::encoding. Packed
+ * encodings fit more of them in cache (Nibble halves them, Mod3 quarters
+ * them); the search tracks exact distances along its path, so every
+ * encoding prunes the same nodes.
+ *
+ * Building the databases takes tens of seconds and happens once per
+ * process on first use.
+ */
+class OptimalTables {
+public:
+    /// Kind tag of optimal table files
+    static constexpr uint32_t kFileKind = 0x4F505431;  // "OPT1"
+
+    /// Tables stored in a file: the three move tables, the three databases, then their encoding
+    static constexpr size_t kFileSections = 7;
+
+    CoordMoveTable cornerPerm;         ///< Corner permutation, all moves
+    CoordMoveTable twist;              ///< Corner twist, all moves
+    TableStorage<uint32_t> edgeMove;   ///< [placement * 18 + move] -> (placement << 6) | flip mask
+
+    PruningTable corners;              ///< Corner pattern database
+    PruningTable edgesLow;             ///< Pattern database of edges 0-5
+    PruningTable edgesHigh;            ///< Pattern database of edges 6-11
+
+    /**
+     * @brief Builds every table
+     * @param options Threads, progress callback and database encoding
+     */
+    explicit OptimalTables(const TableBuildOptions& options = {});
+
+
+    /**
+     * @brief Maps tables saved by save()
+     * @throws TableFileError if a section does not have the expected geometry
+     */
+    explicit OptimalTables(const std::shared_ptr<const TableFile>& file);
+
+    /**
+     * @brief Returns the process-wide tables, built on first use
+     *
+     * If setTableDirectory() was called, the tables are mapped from
+     * "optimal.tables" there, or built and written to it when the file is
+     * missing or invalid.
+     */
+    static const OptimalTables& instance();
+
+    /**
+     * @brief Writes every table to a table file
+     * @throws TableFileError if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Returns the combined memory footprint in bytes
+     */
+    size_t bytes() const;
+
+    /**
+     * @brief Returns the edge-database index of six tracked edges
+     * @param state Cube state
+     * @param firstPiece Lowest tracked piece: 0 for edgesLow, 6 for edgesHigh
+     */
+    static uint32_t edgeIndex(const CubeState& state, int firstPiece);
+
+    /**
+     * @brief Applies a move to an edge-database index
+     */
+    uint32_t moveEdges(uint32_t index, size_t move) const {
+        const uint32_t e = this->edgeMove[(index >> 6) * kMoveCount + move];
+        return (e & ~63u) | ((index ^ e) & 63u);
+    }
+};
+
+/**
+ * @brief Parallelism and caching settings of the optimal search
+ */
+struct OptimalOptions {
+    unsigned threads = 1;        ///< Worker threads; 0 uses every hardware thread
+    bool deterministic = false;  ///< Return the first solution in canonical move order
+    TranspositionTable* transpositions = nullptr;  ///< Bounds to reuse and extend, if given; may be shared between solves
+};
+
+/// Fewest moves left below a state for the search to cache its bound; shallower subtrees are cheaper to search again
+inline constexpr int kTranspositionMinDepth = 4;
+
+/**
+ * @brief Finds a shortest solution with IDA*
+ * @param state Valid cube state
+ * @param limits Deepest bound to try and deadline
+ * @param options Thread count and determinism
+ * @param tables Tables to search with
+ * @return An optimal solution if one of at most limits.maxLength moves
+ *         exists and was found before the deadline; the node count and
+ *         rate are reported either way
+ *
+ * With several threads, each iteration of the deepening loop splits the
+ * tree three moves below the root into a few thousand subtrees that the
+ * workers share through work stealing. All workers search under the same
+ * bound; the next bound starts only after every subtree is exhausted.
+ *
+ * By default the first solution found by any worker stops the others, so
+ * which optimal solution is returned can vary between runs. With
+ * `deterministic` set, a worker stops only for solutions in subtrees that
+ * come earlier in move order, and the result is exactly the solution a
+ * single-threaded search returns.
+ *
+ * With a transposition table, every subtree at least
+ * kTranspositionMinDepth moves deep that the search exhausts stores a
+ * lower bound for its root, and a state reached again with no more moves
+ * left than that bound is skipped. Only subtrees with no solution are
+ * skipped, so the solution is the same as without the table; the node
+ * count drops and the table's counters record the probes. Move pruning
+ * and the databases already keep most duplicate states out of the tree,
+ * so the drop is small, about 1% on 14-move scrambles.
+ */
+SolveResult solveOptimal(const CubeState& state, const SearchLimits& limits, const OptimalOptions& options = {},
+                         const OptimalTables& tables = OptimalTables::instance());
+
+/// Suggested OptimalBatchOptions::interleave when the databases are much larger than the last-level cache
+inline constexpr size_t kOptimalInterleave = 32;
+
+/**
+ * @brief Settings of solveOptimalBatch
+ */
+struct OptimalBatchOptions {
+    unsigned threads = 1;                    ///< Worker threads; 0 uses every hardware thread
+    size_t interleave = 1;                   ///< Solves each worker keeps in flight; 1 solves them one after another
+    std::chrono::milliseconds timeout{0};    ///< Wall-clock limit of each solve from its start; 0 means none
+};
+
+/**
+ * @brief Finds shortest solutions of many cubes, interleaving the searches on each thread
+ * @param states Valid cube states
+ * @param limits Deepest bound to try; the deadline and cancel flag apply to the whole batch
+ * @param options Threads, solves in flight per thread and per-solve timeout
+ * @param tables Tables to search with
+ * @return One result per state, in input order; each is the solution
+ *         solveOptimal() returns with one thread
+ *
+ * When the databases do not fit in the last-level cache, one solve on a
+ * thread spends most of its time waiting for their entries. With
+ * options.interleave above 1 each worker runs that many solves as
+ * coroutines: a solve expands a node, prefetches the entries of all its
+ * children and suspends, and by the time the worker comes back to it the
+ * entries are usually in cache. When the databases do fit, the switching
+ * costs more than it hides, hence the default of 1; try
+ * kOptimalInterleave otherwise. Each result's stats.seconds is the wall
+ * time from its start to its end, which it spent sharing the thread.
+ */
+std::vector<SolveResult> solveOptimalBatch(std::span<const CubeState> states, const SearchLimits& limits,
+                                           const OptimalBatchOptions& options = {},
+                                           const OptimalTables& tables = OptimalTables::instance());
+
+#endif
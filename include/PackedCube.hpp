@@ -0,0 +1,184 @@
+#ifndef PACKED_CUBE_HPP
+#define PACKED_CUBE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include "MoveTables.hpp"
+#include "RubiksCube.hpp"
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file PackedCube.hpp
+ * @brief Byte-packed cube state with shuffle-based move application
+ */
+
+/**
+ * @brief Shuffle and orientation tables for one move on a PackedCube
+ *
+ * Bytes 0-15 describe the corner lane and bytes 16-31 the edge lane. The
+ * shuffle indices are lane-relative, matching the semantics of `pshufb`.
+ * Unused bytes map to themselves with a zero delta.
+ */
+struct PackedMove {
+    alignas(32) std::array<uint8_t, 32> shuffle; ///< Source byte for each destination byte
+    alignas(32) std::array<uint8_t, 32> delta;   ///< Orientation change, pre-shifted into bits 4-5
+};
+
+/**
+ * @brief Derives the packed shuffle/delta tables from the shared move definitions
+ */
+constexpr std::array<PackedMove, 18> buildPackedMoves() {
+    std::array<PackedMove, 18> table{};
+    for (size_t m = 0; m < table.size(); ++m) {
+        const MoveDef& def = g_moveTables[m];
+        for (uint8_t i = 0; i < 16; ++i) {
+            table[m].shuffle[i] = i;
+            table[m].shuffle[16 + i] = i;
+        }
+        for (int i = 0; i < 8; ++i) {
+            table[m].shuffle[i] = def.corner_perm[i];
+            table[m].delta[i] = (uint8_t)(def.corner_ori_delta[i] << 4);
+        }
+        for (int i = 0; i < 12; ++i) {
+            table[m].shuffle[16 + i] = def.edge_perm[i];
+            table[m].delta[16 + i] = (uint8_t)(def.edge_ori_delta[i] << 4);
+        }
+    }
+    return table;
+}
+
+/// Packed move tables indexed by RubiksCube::Move
+inline constexpr std::array<PackedMove, 18> g_packedMoves = buildPackedMoves();
+
+/**
+ * @brief Orientation modulus per byte, pre-shifted into bits 4-5
+ *
+ * After adding a delta, a corner orientation may reach 3 or 4 and an edge
+ * orientation 2. Subtracting the modulus and keeping the unsigned minimum of
+ * the two values reduces it again: for in-range orientations the subtraction
+ * wraps around to a large value and the original byte wins.
+ */
+alignas(32) inline constexpr std::array<uint8_t, 32> g_packedOriModulus = {
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20
+};
+
+/**
+ * @class PackedCube
+ * @brief Compact cube state with one byte per cubie, moved by byte shuffles
+ *
+ * Each cubie is stored as `piece | (orientation << 4)`. Corners occupy the
+ * first 8 bytes of a 128-bit lane and edges the first 12 bytes of a second
+ * lane; the remaining bytes are padding that every move leaves unchanged.
+ *
+ * A move is one byte shuffle per lane (`pshufb`), one add of the orientation
+ * deltas and a subtract/min pair to reduce orientations modulo 3 or 2. With
+ * AVX2 both lanes are processed by a single 256-bit instruction of each kind;
+ * with SSSE3 by two 128-bit ones. Without either, a branch-free scalar loop
+ * performs the same byte operations.
+ *
+ * Converts losslessly to and from RubiksCube.
+ */
+class PackedCube {
+    alignas(32) std::array<uint8_t, 32> bytes; ///< Corner lane (0-15) followed by edge lane (16-31)
+
+public:
+    /**
+     * @brief Constructs a PackedCube in the solved state
+     */
+    PackedCube();
+
+    /**
+     * @brief Packs the state of a RubiksCube
+     * @param cube Cube to convert
+     * @return Equivalent packed state
+     */
+    static PackedCube fromCube(const RubiksCube& cube);
+
+    /**
+     * @brief Unpacks into a RubiksCube
+     * @return Cube with the same pieces and orientations
+     */
+    RubiksCube toCube() const;
+
+    /**
+     * @brief Resets the cube to the solved state
+     */
+    void reset();
+
+    /**
+     * @brief Checks if the cube is in the solved state
+     */
+    bool isSolved() const;
+
+    /**
+     * @brief Applies a single move
+     * @param move Enumerated move value
+     */
+    inline void applyMove(RubiksCube::Move move);
+
+    /**
+     * @brief Returns the packed byte of a corner slot
+     * @param slot Corner slot (0-7)
+     * @return `piece | (orientation << 4)`
+     */
+    uint8_t corner(int slot) const { return bytes[slot]; }
+
+    /**
+     * @brief Returns the packed byte of an edge slot
+     * @param slot Edge slot (0-11)
+     * @return `piece | (orientation << 4)`
+     */
+    uint8_t edge(int slot) const { return bytes[16 + slot]; }
+
+    bool operator==(const PackedCube& other) const {
+        return std::memcmp(bytes.data(), other.bytes.data(), bytes.size()) == 0;
+    }
+    bool operator!=(const PackedCube& other) const { return !(*this == other); }
+};
+
+inline void PackedCube::applyMove(RubiksCube::Move move) {
+    const PackedMove& pm = g_packedMoves[static_cast<size_t>(move)];
+#if defined(__AVX2__)
+    const __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(bytes.data()));
+    const __m256i shuf = _mm256_load_si256(reinterpret_cast<const __m256i*>(pm.shuffle.data()));
+    const __m256i delta = _mm256_load_si256(reinterpret_cast<const __m256i*>(pm.delta.data()));
+    const __m256i mod = _mm256_load_si256(reinterpret_cast<const __m256i*>(g_packedOriModulus.data()));
+    __m256i t = _mm256_add_epi8(_mm256_shuffle_epi8(state, shuf), delta);
+    t = _mm256_min_epu8(t, _mm256_sub_epi8(t, mod));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(bytes.data()), t);
+#elif defined(__SSSE3__)
+    for (int lane = 0; lane < 32; lane += 16) {
+        const __m128i state = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes.data() + lane));
+        const __m128i shuf = _mm_load_si128(reinterpret_cast<const __m128i*>(pm.shuffle.data() + lane));
+        const __m128i delta = _mm_load_si128(reinterpret_cast<const __m128i*>(pm.delta.data() + lane));
+        const __m128i mod = _mm_load_si128(reinterpret_cast<const __m128i*>(g_packedOriModulus.data() + lane));
+        __m128i t = _mm_add_epi8(_mm_shuffle_epi8(state, shuf), delta);
+        t = _mm_min_epu8(t, _mm_sub_epi8(t, mod));
+        _mm_store_si128(reinterpret_cast<__m128i*>(bytes.data() + lane), t);
+    }
+#else
+    // Padding bytes are fixed points of every shuffle, so only the 8 corner
+    // and 12 edge bytes need to be rewritten.
+    std::array<uint8_t, 32> out = bytes;
+    for (int i = 0; i < 8; ++i) {
+        const uint8_t t = (uint8_t)(bytes[pm.shuffle[i]] + pm.delta[i]);
+        const uint8_t reduced = (uint8_t)(t - 0x30);
+        out[i] = reduced < t ? reduced : t;
+    }
+    for (int i = 16; i < 28; ++i) {
+        const uint8_t t = (uint8_t)(bytes[16 + pm.shuffle[i]] + pm.delta[i]);
+        const uint8_t reduced = (uint8_t)(t - 0x20);
+        out[i] = reduced < t ? reduced : t;
+    }
+    bytes = out;
+#endif
+}
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef PRUNING_TABLE_HPP
+#define PRUNING_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+#include "Coordinates.hpp"
+#include "TableStorage.hpp"
+
+/**
+ * @file PruningTable.hpp
+ * @brief Breadth-first distance tables used as search heuristics
+ */
+
+/**
+ * @brief Compile-time switch for software prefetching of table probes
+ *
+ * With 1 (the default) the searches compute the coordinates of every child
+ * of a node, ask the CPU to start loading their pruning table entries, and
+ * only then read them, so the cache misses of one node overlap instead of
+ * running one after another. Build with -DRUBIKS_PREFETCH=0 to probe each
+ * child as it is generated, e.g. to compare both on the same scrambles.
+ */
+#ifndef RUBIKS_PREFETCH
+#define RUBIKS_PREFETCH 1
+#endif
+
+/**
+ * @brief Progress of one table build, reported after each breadth-first level
+ */
+struct TableBuildProgress {
+    int depth;       ///< Distance of the level just labelled
+    size_t reached;  ///< Entries labelled so far, this level included
+    size_t size;     ///< Entries in the table
+};
+
+/**
+ * @brief How distances are stored in a PruningTable
+ */
+enum class PruningEncoding : uint8_t {
+    Byte,    ///< One byte per entry
+    Nibble,  ///< Four bits per entry; distances up to 14
+    Mod3     ///< Two bits per entry holding the distance mod 3; see PruningTable::distance
+};
+
+/**
+ * @brief How tables are built
+ */
+struct TableBuildOptions {
+    unsigned threads = 0;  ///< Threads per breadth-first level; 0 uses every hardware thread
+    PruningEncoding encoding = PruningEncoding::Nibble;  ///< Packing of the optimal solver's pattern databases
+    std::function<void(const TableBuildProgress&)> onProgress;  ///< Called on the building thread; may be empty
+};
+
+/**
+ * @brief Runs scan(begin, end) over blocks of [0, size) on several threads
+ * @return The sum of the values scan returned
+ *
+ * Blocks are handed out from a shared counter, so threads that draw cheap
+ * blocks simply take more of them. With one thread the blocks run in order
+ * on the caller.
+ */
+size_t parallelBlockSum(size_t size, unsigned threads, const std::function<size_t(size_t begin, size_t end)>& scan);
+
+/**
+ * @class PruningTable
+ * @brief Exact distance to the goal for every value of a coordinate
+ *
+ * Entry i holds the minimum number of moves needed to bring coordinate
+ * value i back to the goal. Since a coordinate only sees part of the cube,
+ * that distance is a lower bound on the distance of every full state with
+ * that coordinate, which makes it an admissible heuristic for IDA*.
+ *
+ * Tables are built one byte per entry and can be repacked to fit more of
+ * them in cache:
+ * - Nibble: two entries per byte, exact distances.
+ * - Mod3: four entries per byte, each the distance mod 3. A move changes
+ *   the distance by at most one, so knowing the exact distance of a parent
+ *   and the residue of a child pins down the child's exact distance. A
+ *   search tracks exact distances along its path and only needs one exact
+ *   lookup at the root (exactDistance()).
+ *
+ * Every encoding is read with the same shift-and-mask arithmetic, so a
+ * lookup has no branch on the encoding.
+ */
+class PruningTable {
+    TableStorage<uint8_t> dist; ///< Packed entries, 1, 2 or 4 per byte
+    size_t entries = 0;         ///< Number of coordinate values
+    PruningEncoding packing = PruningEncoding::Byte;
+    uint8_t perByteLog2 = 0;    ///< log2 of entries per byte
+    uint8_t bitsLog2 = 3;       ///< log2 of bits per entry
+    uint8_t valueMask = 0xFF;
+
+public:
+    /// Distance stored for values the search never reached (Nibble tables read it as 0xF)
+    static constexpr uint8_t kUnreached = 0xFF;
+
+    PruningTable() = default;
+
+    /**
+     * @brief Wraps existing entries, e.g. loaded from a table file
+     * @param dist Packed entries
+     * @param entries Number of coordinate values
+     * @param encoding Packing of @p dist
+     */
+    PruningTable(TableStorage<uint8_t> dist, size_t entries, PruningEncoding encoding);
+
+    /**
+     * @brief Wraps one-byte distances
+     */
+    explicit PruningTable(TableStorage<uint8_t> dist)
+        : PruningTable(dist, dist.size(), PruningEncoding::Byte) {}
+
+    /**
+     * @brief Returns the bytes needed to store @p entries entries in @p encoding
+     */
+    static size_t packedBytes(size_t entries, PruningEncoding encoding);
+
+    /**
+     * @brief Builds a table by level-by-level breadth-first search
+     * @param size Number of coordinate values
+     * @param start Coordinate value of the goal (distance 0)
+     * @param expand Callable invoked as expand(index, visit); it must call
+     *               visit(child) for every neighbour of @p index
+     * @param options Thread count and progress callback
+     *
+     * Each level scans the table for entries at the current depth and
+     * labels their unvisited neighbours, so memory stays at one byte per
+     * entry with no queue. Once fewer entries are unreached than sit at the
+     * current depth, levels run backwards instead: each unreached entry is
+     * expanded and labelled if a neighbour is at the current depth. This
+     * relies on the moves being closed under inverses, as every move set
+     * here is, and gives the same table with far fewer expansions.
+     *
+     * Large tables scan each level on several threads. Every write turns an
+     * unreached entry into depth + 1 with an atomic compare-and-swap, so two
+     * threads reaching the same entry agree on its value and entries labelled
+     * during a level are not expanded until the next. Distances therefore do
+     * not depend on the thread count or schedule: the table is bit-identical
+     * to a one-thread build. @p expand is called concurrently and must not
+     * modify shared state.
+     */
+    template <typename Expand>
+    static PruningTable build(size_t size, size_t start, Expand&& expand, const TableBuildOptions& options = {});
+
+    /**
+     * @brief Builds a table whose goal is a set of coordinate values
+     * @param size Number of coordinate values
+     * @param starts Coordinate values at distance 0
+     * @param expand As for the single-goal overload
+     * @param options Thread count and progress callback
+     */
+    template <typename Expand>
+    static PruningTable build(size_t size, std::span<const size_t> starts, Expand&& expand,
+                              const TableBuildOptions& options = {});
+
+    /**
+     * @brief Builds the distance table of a pair of coordinates
+     * @param a Move table of the major coordinate
+     * @param b Move table of the minor coordinate
+     * @param moves Moves allowed in the search
+     * @param options Thread count and progress callback
+     *
+     * The pair (x, y) is stored at index `x * b.size() + y`; the goal is (0, 0).
+     */
+    static PruningTable build(const CoordMoveTable& a, const CoordMoveTable& b,
+                              std::span<const RubiksCube::Move> moves, const TableBuildOptions& options = {});
+
+    /**
+     * @brief Returns a copy of the table in another encoding
+     * @throws std::logic_error if some distance cannot be represented: more
+     *         than 14 for Nibble, unreached entries for Mod3, or if this
+     *         table is not one byte per entry
+     */
+    PruningTable packed(PruningEncoding encoding) const;
+
+    /**
+     * @brief Returns the stored entry of coordinate value @p index
+     *
+     * The exact distance, or for Mod3 tables the distance mod 3.
+     */
+    uint8_t operator[](size_t index) const {
+        const unsigned shift = (unsigned)(index & ((1u << perByteLog2) - 1)) << bitsLog2;
+        return (uint8_t)((dist[index >> perByteLog2] >> shift) & valueMask);
+    }
+
+    /**
+     * @brief Starts loading the entry of @p index into the cache without waiting for it
+     *
+     * A no-op when RUBIKS_PREFETCH is 0 or the compiler has no prefetch intrinsic.
+     */
+    void prefetch(size_t index) const {
+#if RUBIKS_PREFETCH && (defined(__GNUC__) || defined(__clang__))
+        __builtin_prefetch(dist.data() + (index >> perByteLog2));
+#else
+        (void)index;
+#endif
+    }
+
+    /**
+     * @brief Returns the exact distance of @p index given that of a neighbour
+     * @param parentDistance Exact distance of a coordinate one move away
+     */
+    int distance(size_t index, int parentDistance) const {
+        // Residue step -> distance change: the same residue means the same
+        // distance, one more means one further, one less means one closer
+        static constexpr int8_t kStep[3] = {0, 1, -1};
+        const int raw = (*this)[index];
+        if (packing != PruningEncoding::Mod3) return raw;
+        return parentDistance + kStep[(raw - parentDistance % 3 + 3) % 3];
+    }
+
+    /**
+     * @brief Returns the exact distance of @p index with no neighbour known
+     * @param expand As for build(); used to walk downhill in Mod3 tables
+     *
+     * Exact encodings just read the entry. A Mod3 table follows neighbours
+     * one step closer at a time until none is, counting the steps; this
+     * costs a few hundred lookups, once per search.
+     */
+    template <typename Expand>
+    int exactDistance(size_t index, Expand&& expand) const;
+
+    /**
+     * @brief Returns the encoding of the entries
+     */
+    PruningEncoding encoding() const { return packing; }
+
+    /**
+     * @brief Returns the number of entries
+     */
+    size_t size() const { return entries; }
+
+    /**
+     * @brief Returns the table's memory footprint in bytes
+     */
+    size_t bytes() const { return dist.bytes(); }
+
+    /**
+     * @brief Returns the packed entries, for writing to a table file
+     */
+    const TableStorage<uint8_t>& storage() const { return dist; }
+
+    /**
+     * @brief Returns the largest entry in the table (at most 2 for Mod3 tables)
+     */
+    uint8_t maxDistance() const;
+};
+
+template <typename Expand>
+int PruningTable::exactDistance(size_t index, Expand&& expand) const {
+    if (this->packing != PruningEncoding::Mod3) return (*this)[index];
+    // A neighbour with residue one less is one move closer; only goal
+    // entries have none, since no neighbour of a goal can be at distance 2
+    int steps = 0;
+    for (bool descended = true; descended; ) {
+        const uint8_t closer = (uint8_t)(((*this)[index] + 2) % 3);
+        descended = false;
+        expand(index, [&](size_t child) {
+            if (!descended && (*this)[child] == closer) {
+                index = child;
+                descended = true;
+            }
+        });
+        steps += descended;
+    }
+    return steps;
+}
+
+/**
+ * @brief Returns the threads worth using for one level of a table of @p size entries
+ */
+unsigned tableBuildThreads(size_t size, unsigned requested);
+
+template <typename Expand>
+PruningTable PruningTable::build(size_t size, size_t start, Expand&& expand, const TableBuildOptions& options) {
+    const size_t starts[1] = {start};
+    return build(size, std::span<const size_t>(starts), expand, options);
+}
+
+template <typename Expand>
+PruningTable PruningTable::build(size_t size, std::span<const size_t> starts, Expand&& expand,
+                                 const TableBuildOptions& options) {
+    std::vector<uint8_t> built(size, kUnreached);
+    for (size_t s : starts) built[s] = 0;
+
+    const unsigned threads = tableBuildThreads(size, options.threads);
+    uint8_t* dist = built.data();
+    size_t reached = starts.size();
+    size_t frontier = starts.size();
+    for (uint8_t depth = 0; frontier > 0; ++depth) {
+        const bool backward = size - reached < frontier;
+        frontier = parallelBlockSum(size, threads, [&](size_t begin, size_t end) {
+            size_t labelled = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (backward) {
+                    // Only this thread writes entries of its block
+                    if (dist[i] != kUnreached) continue;
+                    bool found = false;
+                    expand(i, [&](size_t child) {
+                        found = found || std::atomic_ref<uint8_t>(dist[child]).load(std::memory_order_relaxed) == depth;
+                    });
+                    if (!found) continue;
+                    std::atomic_ref<uint8_t>(dist[i]).store((uint8_t)(depth + 1), std::memory_order_relaxed);
+                    ++labelled;
+                    continue;
+                }
+                if (std::atomic_ref<uint8_t>(dist[i]).load(std::memory_order_relaxed) != depth) continue;
+                expand(i, [&](size_t child) {
+                    std::atomic_ref<uint8_t> entry(dist[child]);
+                    if (entry.load(std::memory_order_relaxed) != kUnreached) return;
+                    if (threads == 1) {
+                        // No other writer, so the locked exchange can be skipped
+                        entry.store((uint8_t)(depth + 1), std::memory_order_relaxed);
+                        ++labelled;
+                        return;
+                    }
+                    uint8_t expected = kUnreached;
+                    if (entry.compare_exchange_strong(expected, (uint8_t)(depth + 1), std::memory_order_relaxed)) {
+                        ++labelled;
+                    }
+                });
+            }
+            return labelled;
+        });
+        reached += frontier;
+        if (options.onProgress && frontier > 0) options.onProgress({depth + 1, reached, size});
+    }
+    return PruningTable(TableStorage<uint8_t>(std::move(built)));
+}
+
+#endif
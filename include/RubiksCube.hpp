@@ -4,6 +4,11 @@
 #include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
+
+struct MoveDef;
+class CompiledSequence;
+class MoveSequence;
 
 /**
  * @file RubiksCube.hpp
@@ -30,24 +35,20 @@
  * 
  * ## Corner Indexing (0-7)
  * ```
- *     4 --- 5
- *    /|    /|
- *   0 --- 1 |
- *   | 7 --|-6
- *   |/    |/
- *   3 --- 2
+ *   0 = URF   1 = UFL   2 = ULB   3 = UBR
+ *   4 = DFR   5 = DLF   6 = DBL   7 = DRB
  * ```
+ * Corners 0-3 lie in the U layer and 4-7 in the D layer. Orientation counts
+ * clockwise twists of the piece's U/D sticker away from the U/D face.
  * 
  * ## Edge Indexing (0-11)
  * ```
- *     +--4--+
- *    /|    /|
- *   8 0   9 1
- *   | +--5-|-+
- *   |/    |/
- *  11 3--10 2
- *   Back: 6,7 (not visible)
+ *   0 = UR   1 = UF   2 = UL   3 = UB
+ *   4 = DR   5 = DF   6 = DL   7 = DB
+ *   8 = FR   9 = FL  10 = BL  11 = BR
  * ```
+ * Edges 8-11 form the middle (UD) slice. An edge is flipped (orientation 1)
+ * when only an F or B quarter turn could have moved it to its current slot.
  * 
  * ## Move Notation
  * Standard Singmaster notation is supported:
@@ -81,6 +82,11 @@ private:
     std::array<CornerPiece, 8> corners;  ///< Array of corner pieces
     std::array<EdgePiece, 12> edges;     ///< Array of edge pieces
 
+    /**
+     * @brief Applies an arbitrary permutation with orientation changes in one pass
+     */
+    void applyDefinition(const MoveDef& def);
+
 public:
     /**
      * @brief Enumerates all supported face turns in Singmaster notation
@@ -100,11 +106,6 @@ public:
      * @brief Constructs a new RubiksCube in the solved state
      */
     RubiksCube();
-    
-    /**
-     * @brief Destructor
-     */
-    ~RubiksCube();
 
     /**
      * @brief Resets the cube to the solved state
@@ -119,6 +120,93 @@ public:
      */
     bool isSolved() const;
 
+    /**
+     * @brief Compares two cube states piece by piece
+     */
+    bool operator==(const RubiksCube& other) const;
+    bool operator!=(const RubiksCube& other) const { return !(*this == other); }
+
+    /**
+     * @brief Composes two cube states as permutations with orientations
+     * @param a State whose moves are performed first
+     * @param b State whose moves are performed second
+     * @return The state reached by performing a's moves and then b's moves,
+     *         starting from solved
+     * 
+     * Every cube state is the permutation (with orientation changes) that
+     * takes the solved cube to it, so states can be used as precomputed
+     * algorithms: `compose(cube, alg)` applies a whole algorithm in one pass.
+     * Composition is associative but not commutative.
+     */
+    static RubiksCube compose(const RubiksCube& a, const RubiksCube& b);
+
+    /**
+     * @brief Returns the inverse state
+     * @return The state x with compose(*this, x) and compose(x, *this) solved
+     * 
+     * The moves that take this cube to an arbitrary target state t are
+     * described by `compose(inverse(), t)`.
+     */
+    RubiksCube inverse() const;
+
+    /**
+     * @brief Composes this state with itself
+     * @param k Exponent; 0 yields the solved state and negative values
+     *          raise the inverse to -k
+     * @return This state composed with itself k times
+     * 
+     * Uses repeated squaring, so the cost is logarithmic in |k|.
+     */
+    RubiksCube pow(int k) const;
+
+    /**
+     * @brief Returns the corner piece occupying a slot
+     * @param slot Corner slot (0-7)
+     */
+    uint8_t cornerPiece(int slot) const;
+
+    /**
+     * @brief Returns the twist of the corner piece in a slot
+     * @param slot Corner slot (0-7)
+     * @return Orientation (0-2)
+     */
+    uint8_t cornerOrientation(int slot) const;
+
+    /**
+     * @brief Returns the edge piece occupying a slot
+     * @param slot Edge slot (0-11)
+     */
+    uint8_t edgePiece(int slot) const;
+
+    /**
+     * @brief Returns the flip of the edge piece in a slot
+     * @param slot Edge slot (0-11)
+     * @return Orientation (0-1)
+     */
+    uint8_t edgeOrientation(int slot) const;
+
+    /**
+     * @brief Places a corner piece into a slot
+     * @param slot Corner slot (0-7)
+     * @param piece Corner piece (0-7)
+     * @param orientation Twist (0-2)
+     * 
+     * Intended for conversions from other state representations; the caller
+     * is responsible for producing a consistent permutation.
+     */
+    void setCorner(int slot, uint8_t piece, uint8_t orientation);
+
+    /**
+     * @brief Places an edge piece into a slot
+     * @param slot Edge slot (0-11)
+     * @param piece Edge piece (0-11)
+     * @param orientation Flip (0-1)
+     * 
+     * Intended for conversions from other state representations; the caller
+     * is responsible for producing a consistent permutation.
+     */
+    void setEdge(int slot, uint8_t piece, uint8_t orientation);
+
     /**
      * @brief Rotates a face of the cube
      * @param face Face to rotate (0=U, 1=D, 2=R, 3=L, 4=F, 5=B)
@@ -131,7 +219,7 @@ public:
      * @param move Move string (e.g., "U", "R'", "F2")
      * @throws std::invalid_argument if move is not recognized
      * 
-     * Supported moves:
+     * Parses the token and forwards to applyMove(Move). Supported moves:
      * - Base moves: U, D, R, L, F, B (clockwise quarter turns)
      * - Inverse moves: U', D', R', L', F', B' (counter-clockwise)
      * - Double moves: U2, D2, R2, L2, F2, B2 (180-degree turns)
@@ -141,18 +229,51 @@ public:
     /**
      * @brief Applies a single move specified by the Move enum
      * @param move Enumerated move value (e.g., Move::U, Move::R_PRIME, Move::F2)
+     * 
+     * Looks the move up directly in the compile-time move table; no string
+     * handling or allocation is involved.
      */
     void applyMove(Move move);
 
+    /**
+     * @brief Parses a single move token in Singmaster notation
+     * @param token Move string (e.g., "U", "R'", "F2")
+     * @return The corresponding enumerated move
+     * @throws std::invalid_argument if the token is not one of the 18 moves
+     */
+    static Move parseMove(const std::string& token);
+
+    /**
+     * @brief Returns the Singmaster name of a move (e.g., "R'")
+     */
+    static const char* moveName(Move move);
+
     /**
      * @brief Applies a sequence of space-separated moves
      * @param moves String containing multiple moves separated by spaces
-     * @throws std::invalid_argument if any move is not recognized
+     * @throws std::invalid_argument if any move is not recognized; the
+     *         message includes the position of the offending character
      * 
      * Example: "R U R' U' R U R' F' R U R' U' R' F R"
+     * 
+     * The string is parsed in place (see forEachMove) without allocating.
      */
     void applyMoves(const std::string& moves);
 
+    /**
+     * @brief Applies a packed move sequence
+     * @param moves Moves to apply in order
+     */
+    void applyMoves(const MoveSequence& moves);
+
+    /**
+     * @brief Applies a precompiled move sequence in a single pass
+     * @param sequence Sequence folded into one permutation by CompiledSequence
+     * 
+     * The cost is that of one move, regardless of the sequence length.
+     */
+    void applySequence(const CompiledSequence& sequence);
+
     /**
      * @brief Scrambles the cube with random moves
      * @param length Number of random moves to apply (default: 25)
@@ -160,7 +281,9 @@ public:
      * 
      * Applies random moves from the complete move set and returns the 
      * sequence for reference. A length of 20-25 moves typically provides
-     * a well-scrambled cube.
+     * a well-scrambled cube. Moves are drawn by a per-thread
+     * ScrambleGenerator seeded from std::random_device; use
+     * ScrambleGenerator directly for reproducible scrambles.
      */
     std::string scramble(int length = 25);
 
@@ -172,6 +295,19 @@ public:
      * Useful for debugging and verifying cube state.
      */
     std::string toString() const;
+
+    /**
+     * @brief Builds a cube from a 54-character facelet string
+     * @param facelets Sticker letters in URFDLB order (see Facelets.hpp)
+     * @return Cube in the described state
+     * @throws std::invalid_argument if the string does not describe a reachable cube
+     */
+    static RubiksCube fromFacelets(std::string_view facelets);
+
+    /**
+     * @brief Returns the 54 sticker letters of the cube in URFDLB order
+     */
+    std::string toFacelets() const;
         
 };
 
@@ -1,12 +1,197 @@
 #ifndef Rubiks_CUBE_SOLVER_HPP
 #define Rubiks_CUBE_SOLVER_HPP
 
-#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <vector>
+#include "RubiksCube.hpp"
+#include "SolveResult.hpp"
 
+/**
+ * @file RubiksCubeSolver.hpp
+ * @brief Front end that solves RubiksCube states with a configurable algorithm
+ */
+
+/**
+ * @brief Algorithms the solver can use
+ */
+enum class SolveMethod {
+    TwoPhase,  ///< Kociemba's two-phase algorithm: near-optimal in milliseconds
+    Optimal,   ///< Korf's IDA* with pattern databases: shortest solution, ~220 MB of tables
+    Thistlethwaite ///< Four-phase descent: at most 45 moves, microseconds, ~7 MB of tables
+};
+
+/**
+ * @brief Availability of the tables of one method
+ */
+enum class TableState {
+    Absent,    ///< Not built yet and no build started
+    Building,  ///< Being built; solves needing them block or fall back
+    Live       ///< Built and in use
+};
+
+/**
+ * @brief Table availability of every method, as reported by RubiksCubeSolver::tableStatus()
+ */
+struct TableStatus {
+    TableState twoPhase = TableState::Absent;
+    TableState optimal = TableState::Absent;
+    TableState thistlethwaite = TableState::Absent;
+};
+
+/**
+ * @brief Settings shared by every solve of a RubiksCubeSolver
+ */
+struct SolverConfig {
+    SolveMethod method = SolveMethod::TwoPhase;  ///< Algorithm to use
+    int maxLength = 21;                          ///< Longest acceptable solution in face turns (Optimal caps it at 20; Thistlethwaite ignores it)
+    int targetLength = -1;                       ///< TwoPhase: keep shortening solutions until one is this short; -1 means maxLength
+    std::chrono::milliseconds timeout{10000};    ///< Time limit per solve; 0 means no limit
+    bool allOrientations = false;                ///< TwoPhase: race six searches over rotations and the inverse, one thread each
+    unsigned threads = 1;                        ///< Search threads for Optimal; 0 uses every hardware thread
+    bool deterministic = false;                  ///< Optimal: same solution as a one-thread search, whatever the thread count
+    bool waitForTables = true;                   ///< false: while the method's tables build in the background, answer with a method whose tables are ready
+    size_t interleave = 1;                       ///< Optimal solveBatch: solves each worker interleaves (see solveOptimalBatch); 1 solves one at a time
+};
+
+/**
+ * @class RubiksCubeSolver
+ * @brief Finds move sequences that bring a cube back to the solved state
+ *
+ * The solver itself is lightweight: the lookup tables each algorithm needs
+ * are built once per process on first use and shared read-only by every
+ * solver instance and thread.
+ *
+ * Building the optimal or the two-phase tables takes tens of seconds on
+ * one core (less with more threads). A service that must
+ * answer at once can turn off SolverConfig::waitForTables: until the
+ * tables are live, Optimal solves are answered by TwoPhase if its tables
+ * are ready and otherwise by Thistlethwaite, whose tables build in a
+ * fraction of a second; TwoPhase solves fall back to Thistlethwaite. Such
+ * results have SolveResult::degraded set. Background builds run on
+ * detached threads, so see buildTablesInBackground() before exiting.
+ *
+ * ## Usage
+ * ```
+ * RubiksCubeSolver solver({.maxLength = 20, .timeout = std::chrono::seconds(1)});
+ * SolveResult r = solver.solve(cube);
+ * if (r.solved) cube.applyMoves(r.moves);
+ * ```
+ */
 class RubiksCubeSolver {
-    public:
-        RubiksCubeSolver();
-        ~RubiksCubeSolver();
+    SolverConfig settings; ///< Current configuration
+
+public:
+    /**
+     * @brief Constructs a solver
+     * @param config Algorithm, length limit and timeout
+     *
+     * With config.waitForTables off, the tables of the configured method
+     * start building in the background right away.
+     */
+    explicit RubiksCubeSolver(const SolverConfig& config = {});
+
+    /**
+     * @brief Returns the current configuration
+     */
+    const SolverConfig& config() const { return settings; }
+
+    /**
+     * @brief Replaces the configuration used by later solves
+     */
+    void setConfig(const SolverConfig& config);
+
+    /**
+     * @brief Solves a cube
+     * @param cube State to solve; it is not modified
+     * @return Solution with statistics; `solved` is false if no solution
+     *         within the length limit was found before the timeout
+     * @throws std::invalid_argument if the cube is not a reachable state
+     */
+    SolveResult solve(const RubiksCube& cube) const;
+
+    /**
+     * @brief Solves a cube, improving the solution until a deadline
+     * @param cube State to solve; it is not modified
+     * @param deadline Instant at which the best solution so far is returned;
+     *                 replaces the configured timeout
+     * @param onImprovement Called with each solution strictly shorter than
+     *                      the ones before, as soon as it is found; may be empty
+     * @param cancel Returns early with the best solution so far once another
+     *               thread sets it; may be null
+     * @return The shortest solution found
+     * @throws std::invalid_argument if the cube is not a reachable state
+     *
+     * With TwoPhase the first solution usually arrives within milliseconds
+     * and shorter ones follow while time remains. The search stops early
+     * only once a solution reaches config().targetLength, or, if that is -1,
+     * once no shorter solution can exist. Optimal and Thistlethwaite produce a
+     * single solution, reported once.
+     *
+     * ## Usage
+     * ```
+     * auto r = solver.solveWithin(cube, std::chrono::milliseconds(5),
+     *                             [](const MoveSequence& m) { publish(m); });
+     * ```
+     */
+    SolveResult solveWithin(const RubiksCube& cube, std::chrono::steady_clock::time_point deadline,
+                            const SolutionCallback& onImprovement = {},
+                            const std::atomic<bool>* cancel = nullptr) const;
+
+    /**
+     * @brief Solves a cube, improving the solution for at most @p budget
+     *
+     * Same as the deadline overload with a deadline of now plus @p budget.
+     */
+    SolveResult solveWithin(const RubiksCube& cube, std::chrono::microseconds budget,
+                            const SolutionCallback& onImprovement = {},
+                            const std::atomic<bool>* cancel = nullptr) const;
+
+    /**
+     * @brief Solves many cubes on a set of worker threads
+     * @param cubes States to solve; none is modified
+     * @param threads Worker threads; 0 uses every hardware thread
+     * @return One result per cube, in input order, each with its own stats
+     * @throws std::invalid_argument naming the first unreachable cube; no
+     *         cube is solved in that case
+     *
+     * The tables are built once before the workers start and are shared
+     * read-only by all of them. Each cube is solved on one thread as solve()
+     * would, with the timeout applying per cube; config().threads and
+     * config().allOrientations are ignored, since the batch already keeps
+     * every worker busy. Workers steal cubes from each other, so a few slow
+     * solves do not leave the other threads idle.
+     *
+     * With the Optimal method and config().interleave above 1, each worker
+     * instead runs that many solves at once as coroutines, switching between
+     * them while their pattern database entries load. This pays off when
+     * the databases are much larger than the last-level cache; when they
+     * fit, the switching costs more than it hides.
+     */
+    std::vector<SolveResult> solveBatch(std::span<const RubiksCube> cubes, unsigned threads = 0) const;
+
+    /**
+     * @brief Starts building the tables of @p method on a background thread
+     *
+     * Returns at once. Does nothing if the tables are live or already
+     * building. The finished tables are published atomically; solves that
+     * began before then keep using their fallback. If the build throws,
+     * e.g. std::bad_alloc, the tables go back to Absent and solves keep
+     * falling back until another build is started.
+     *
+     * The build runs on a detached thread that uses process-wide objects,
+     * so a build in flight must finish before the process exits normally:
+     * wait until tableStatus() no longer reports Building before returning
+     * from main() or calling exit(), or leave with std::quick_exit(), which
+     * runs no static destructors.
+     */
+    static void buildTablesInBackground(SolveMethod method);
+
+    /**
+     * @brief Reports which tables are live, building or absent
+     */
+    static TableStatus tableStatus();
 };
 
-#endif
\ No newline at end of file
+#endif
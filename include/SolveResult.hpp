@@ -0,0 +1,58 @@
+#ifndef SOLVE_RESULT_HPP
+#define SOLVE_RESULT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include "MoveSequence.hpp"
+
+/**
+ * @file SolveResult.hpp
+ * @brief Result, statistics and limits shared by the solver back ends
+ */
+
+/**
+ * @brief Work done by one solve
+ */
+struct SolveStats {
+    uint64_t nodes = 0;   ///< Search nodes generated
+    double seconds = 0;   ///< Wall-clock time spent searching
+
+    /**
+     * @brief Returns the search rate, or 0 if no time was measured
+     */
+    double nodesPerSecond() const { return seconds > 0 ? (double)nodes / seconds : 0.0; }
+};
+
+/**
+ * @brief Outcome of solving one cube
+ */
+struct SolveResult {
+    bool solved = false;    ///< true if moves brings the cube to the solved state
+    bool timedOut = false;  ///< true if the search stopped at the deadline
+    bool degraded = false;  ///< true if a fallback method answered while the configured one's tables were building
+    MoveSequence moves;     ///< Solution, valid when solved is true
+    SolveStats stats;       ///< Work done by the search
+};
+
+/**
+ * @brief Bounds a back end must respect while searching
+ */
+struct SearchLimits {
+    int maxLength = 21;                               ///< Longest acceptable solution
+    int targetLength = -1;                            ///< Two-phase: keep shortening solutions until one is this short; -1 means maxLength
+    std::chrono::steady_clock::time_point deadline =  ///< Give up after this instant
+        std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool>* cancel = nullptr;        ///< Stop as soon as another thread sets this, if given
+};
+
+/**
+ * @brief Receives each solution that is strictly shorter than the ones before
+ *
+ * Called on a search thread while the search is paused, so it should return
+ * quickly; the sequence is only valid during the call.
+ */
+using SolutionCallback = std::function<void(const MoveSequence& moves)>;
+
+#endif
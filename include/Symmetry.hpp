@@ -0,0 +1,206 @@
+#ifndef SYMMETRY_HPP
+#define SYMMETRY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "CubeState.hpp"
+#include "MoveTables.hpp"
+
+/**
+ * @file Symmetry.hpp
+ * @brief Whole-cube rotations and conjugation of states and moves
+ *
+ * Conjugating a state X by a rotation S gives S^-1 X S: the same
+ * scramble seen from another side of the cube. It has the same distance
+ * to solved as X, and applying move m to X corresponds to applying the
+ * conjugated move S^-1 m S to the conjugate, which is again a face turn.
+ */
+
+/**
+ * @brief Rotation by 120 degrees about the URF-DBL diagonal
+ *
+ * Maps the U face to R, R to F and F to U. Written as a MoveDef so it
+ * composes with face turns; it is not itself a face turn.
+ */
+inline constexpr MoveDef g_urfRotation = {
+    {0, 4, 5, 1, 3, 7, 6, 2},
+    {1, 2, 1, 2, 2, 1, 2, 1},
+    {1, 8, 5, 9, 3, 11, 7, 10, 0, 4, 6, 2},
+    {1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1}
+};
+
+/**
+ * @brief Returns the move S^-1 m S for every move m, or 0xFF if it is not a face turn
+ */
+constexpr std::array<uint8_t, 18> buildConjugateMoves(const MoveDef& s) {
+    std::array<uint8_t, 18> table{};
+    const MoveDef inv = inverseMove(s);
+    for (size_t m = 0; m < 18; ++m) {
+        const MoveDef c = composeMoves(composeMoves(inv, g_moveTables[m]), s);
+        table[m] = 0xFF;
+        for (size_t k = 0; k < 18; ++k) {
+            if (sameMove(c, g_moveTables[k])) table[m] = (uint8_t)k;
+        }
+    }
+    return table;
+}
+
+/// Conjugates of the 18 moves by g_urfRotation
+inline constexpr std::array<uint8_t, 18> g_urfConjugateMove = buildConjugateMoves(g_urfRotation);
+
+/// Conjugates of the 18 moves by the inverse of g_urfRotation
+inline constexpr std::array<uint8_t, 18> g_urfInverseConjugateMove =
+    buildConjugateMoves(inverseMove(g_urfRotation));
+
+/**
+ * @brief Returns the conjugate S^-1 X S of a state
+ */
+constexpr CubeState conjugate(const CubeState& x, const MoveDef& s) {
+    CubeState r = CubeState::solved();
+    r.apply(inverseMove(s));
+    // Apply x as a permutation of slots with orientation changes
+    MoveDef xd{};
+    for (int i = 0; i < 8; ++i) {
+        xd.corner_perm[i] = x.cornerPiece(i);
+        xd.corner_ori_delta[i] = x.cornerOrientation(i);
+    }
+    for (int i = 0; i < 12; ++i) {
+        xd.edge_perm[i] = x.edgePiece(i);
+        xd.edge_ori_delta[i] = x.edgeOrientation(i);
+    }
+    r.apply(xd);
+    r.apply(s);
+    return r;
+}
+
+/// Symmetries of the cube that keep the U-D axis: 4 turns about it, times a half turn about F-B, times a mirror
+inline constexpr size_t kUDSymmetryCount = 16;
+
+/**
+ * @brief Rotation by 90 degrees about the U-D axis, seen from U
+ */
+inline constexpr MoveDef g_u4Rotation = {
+    {3, 0, 1, 2, 7, 4, 5, 6},
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    {3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10},
+    {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1}
+};
+
+/**
+ * @brief Rotation by 180 degrees about the F-B axis
+ */
+inline constexpr MoveDef g_f2Rotation = {
+    {5, 4, 7, 6, 1, 0, 3, 2},
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    {6, 5, 4, 7, 2, 1, 0, 3, 9, 8, 11, 10},
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+};
+
+/// Slot permutations of the reflection through the plane between L and R
+inline constexpr std::array<uint8_t, 8> g_lrMirrorCorners = {1, 0, 3, 2, 5, 4, 7, 6};
+inline constexpr std::array<uint8_t, 12> g_lrMirrorEdges = {2, 1, 0, 3, 6, 5, 4, 7, 9, 8, 11, 10};
+
+/**
+ * @brief Returns the mirror image of a state through the plane between L and R
+ *
+ * A reflection is not a rotation, so it cannot be written as a MoveDef:
+ * it swaps the L and R slots and turns every corner twist the other way.
+ * It is its own inverse, so this is also the conjugate by the reflection.
+ */
+constexpr CubeState mirrorLR(const CubeState& x) {
+    CubeState r{};
+    for (int i = 0; i < 8; ++i) {
+        const int from = g_lrMirrorCorners[i];
+        r.corners[i] = (uint8_t)(g_lrMirrorCorners[x.cornerPiece(from)] | (((3 - x.cornerOrientation(from)) % 3) << 4));
+    }
+    for (int i = 0; i < 12; ++i) {
+        const int from = g_lrMirrorEdges[i];
+        r.edges[i] = (uint8_t)(g_lrMirrorEdges[x.edgePiece(from)] | (x.edgeOrientation(from) << 4));
+    }
+    return r;
+}
+
+/**
+ * @brief Returns the rotation part F2^f U4^u of every UD symmetry, indexed by `4 * f + u`
+ */
+constexpr std::array<MoveDef, kUDSymmetryCount / 2> buildUDRotations() {
+    std::array<MoveDef, kUDSymmetryCount / 2> rotations{};
+    for (size_t i = 0; i < rotations.size(); ++i) {
+        MoveDef r = (i & 4) ? g_f2Rotation : identityMove();
+        for (size_t u = 0; u < (i & 3); ++u) r = composeMoves(r, g_u4Rotation);
+        rotations[i] = r;
+    }
+    return rotations;
+}
+
+/// Rotation part of each UD symmetry; see conjugateUD
+inline constexpr std::array<MoveDef, kUDSymmetryCount / 2> g_udRotations = buildUDRotations();
+
+/**
+ * @brief Returns the conjugate S^-1 X S by UD symmetry @p sym (0-15)
+ *
+ * Symmetry `8 * f + 2 * u + m` is S = F2^f U4^u LR^m: a half turn about
+ * F-B if f is 1, u quarter turns about U-D, then the mirror if m is 1.
+ * Symmetry 0 is the identity. Conjugating by S then by T is conjugating
+ * by the product ST.
+ */
+constexpr CubeState conjugateUD(const CubeState& x, size_t sym) {
+    const CubeState r = conjugate(x, g_udRotations[sym >> 1]);
+    return (sym & 1) ? mirrorLR(r) : r;
+}
+
+/**
+ * @brief Returns, for each UD symmetry, the symmetry that undoes its conjugation
+ */
+constexpr std::array<uint8_t, kUDSymmetryCount> buildUDSymmetryInverses() {
+    // A state with no symmetry of its own tells the conjugates apart
+    CubeState probe = CubeState::solved();
+    for (size_t m : {0, 6, 12, 4, 8, 15, 9, 1}) probe.apply(g_moveTables[m]);
+    std::array<uint8_t, kUDSymmetryCount> inverse{};
+    for (size_t s = 0; s < kUDSymmetryCount; ++s) {
+        const CubeState c = conjugateUD(probe, s);
+        for (size_t t = 0; t < kUDSymmetryCount; ++t) {
+            if (conjugateUD(c, t) == probe) inverse[s] = (uint8_t)t;
+        }
+    }
+    return inverse;
+}
+
+/// Inverse of each UD symmetry: conjugating by s and then by g_udSymmetryInverse[s] gives back the state
+inline constexpr std::array<uint8_t, kUDSymmetryCount> g_udSymmetryInverse = buildUDSymmetryInverses();
+
+namespace detail {
+    constexpr bool urfRotationValid() {
+        const MoveDef r3 = composeMoves(composeMoves(g_urfRotation, g_urfRotation), g_urfRotation);
+        if (!sameMove(r3, identityMove())) return false;
+        for (uint8_t m : g_urfConjugateMove) {
+            if (m == 0xFF) return false;
+        }
+        // U -> R -> F -> U under the rotation
+        return g_urfConjugateMove[0] != 0 && g_urfConjugateMove[g_urfConjugateMove[g_urfConjugateMove[0]]] == 0;
+    }
+    static_assert(urfRotationValid(), "URF rotation must have order 3 and map face turns to face turns");
+
+    constexpr bool udSymmetriesValid() {
+        for (const MoveDef& r : {g_u4Rotation, g_f2Rotation}) {
+            for (uint8_t m : buildConjugateMoves(r)) {
+                // U and D turns stay U and D turns
+                if (m == 0xFF) return false;
+            }
+            if (buildConjugateMoves(r)[0] / 3 != 0 && buildConjugateMoves(r)[0] / 3 != 1) return false;
+        }
+        // The mirror turns R into L' and keeps U a U-face turn, reversed
+        const CubeState solved = CubeState::solved();
+        if (mirrorLR(solved.moved(RubiksCube::Move::R)) != solved.moved(RubiksCube::Move::L_PRIME)) return false;
+        if (mirrorLR(solved.moved(RubiksCube::Move::U)) != solved.moved(RubiksCube::Move::U_PRIME)) return false;
+        if (mirrorLR(solved.moved(RubiksCube::Move::F)) != solved.moved(RubiksCube::Move::F_PRIME)) return false;
+        for (size_t s = 0; s < kUDSymmetryCount; ++s) {
+            if (conjugateUD(solved, s) != solved) return false;
+        }
+        return true;
+    }
+    static_assert(udSymmetriesValid(), "UD symmetries must map face turns to face turns and fix the solved state");
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef SYMMETRY_COORDINATES_HPP
+#define SYMMETRY_COORDINATES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "Coordinates.hpp"
+#include "Symmetry.hpp"
+#include "TableStorage.hpp"
+
+/**
+ * @file SymmetryCoordinates.hpp
+ * @brief Coordinates reduced by the 16 symmetries that keep the U-D axis
+ *
+ * Conjugating a state by a UD symmetry (conjugateUD) keeps it in the same
+ * phase of the two-phase algorithm at the same distance, so a pruning table
+ * only needs one entry per symmetry class. A sym-coordinate names the class
+ * of a raw coordinate and the symmetry that maps the raw value onto the
+ * class representative; other coordinates looked up alongside it are
+ * conjugated by that same symmetry.
+ */
+
+/// Combined flip and unordered slice coordinate: slice * 2048 + flip
+inline constexpr size_t kFlipSliceCount = kSliceCount * kFlipCount;
+
+/// Symmetry classes of the flip-slice coordinate
+inline constexpr size_t kFlipSliceClassCount = 64430;
+
+/// Symmetry classes of the corner permutation coordinate
+inline constexpr size_t kCornerPermClassCount = 2768;
+
+/**
+ * @brief Flip-slice coordinate (0-1013759), sliceCoord * 2048 + flipCoord
+ */
+uint32_t flipSliceCoord(const CubeState& s);
+
+/**
+ * @class SymCoordTable
+ * @brief Symmetry classes of one raw coordinate
+ *
+ * Each raw value maps to `(class << 4) | sym` where conjugating a state
+ * with that value by UD symmetry sym gives the class representative. The
+ * representative of a class is its smallest raw value.
+ *
+ * Some representatives are their own conjugates under symmetries other
+ * than the identity. A state with such a representative has symmetric
+ * twins that share its class but differ in the other coordinates, and a
+ * pruning table over classes must label the twins together.
+ */
+class SymCoordTable {
+    TableStorage<uint32_t> classOf;  ///< Raw value -> (class << 4) | symmetry
+    TableStorage<uint32_t> reps;     ///< Class -> raw value of its representative
+    TableStorage<uint16_t> selfSyms; ///< Class -> mask of symmetries fixing the representative
+
+public:
+    SymCoordTable() = default;
+
+    /**
+     * @brief Wraps existing tables, e.g. loaded from a table file
+     */
+    SymCoordTable(TableStorage<uint32_t> classOf, TableStorage<uint32_t> reps, TableStorage<uint16_t> selfSyms)
+        : classOf(std::move(classOf)), reps(std::move(reps)), selfSyms(std::move(selfSyms)) {}
+
+    /**
+     * @brief Sorts every raw value into its symmetry class
+     * @param size Number of raw values
+     * @param coordOf Maps a CubeState to its raw value
+     * @param moves Moves that together reach all @p size values from solved
+     * @throws std::logic_error if some value is never reached or a conjugate
+     *         falls outside the coordinate
+     *
+     * Values are visited in increasing order; each one not yet classified
+     * starts a new class and classifies its 16 conjugates.
+     */
+    static SymCoordTable build(size_t size, uint32_t (*coordOf)(const CubeState&),
+                               std::span<const RubiksCube::Move> moves);
+
+    /**
+     * @brief Returns `(class << 4) | sym` for raw value @p raw
+     */
+    uint32_t operator[](size_t raw) const { return classOf[raw]; }
+
+    /**
+     * @brief Returns the raw value of the representative of class @p cls
+     */
+    uint32_t representative(size_t cls) const { return reps[cls]; }
+
+    /**
+     * @brief Returns the mask of symmetries whose conjugate of class @p cls's representative is itself
+     *
+     * Bit 0, the identity, is always set.
+     */
+    uint16_t symmetries(size_t cls) const { return selfSyms[cls]; }
+
+    /**
+     * @brief Returns the number of raw values
+     */
+    size_t size() const { return classOf.size(); }
+
+    /**
+     * @brief Returns the number of symmetry classes
+     */
+    size_t classCount() const { return reps.size(); }
+
+    /**
+     * @brief Returns the table's memory footprint in bytes
+     */
+    size_t bytes() const { return classOf.bytes() + reps.bytes() + selfSyms.bytes(); }
+
+    /**
+     * @brief Returns the raw value -> class table, for writing to a table file
+     */
+    const TableStorage<uint32_t>& classStorage() const { return classOf; }
+
+    /**
+     * @brief Returns the class -> representative table, for writing to a table file
+     */
+    const TableStorage<uint32_t>& representativeStorage() const { return reps; }
+
+    /**
+     * @brief Returns the class -> self-symmetry table, for writing to a table file
+     */
+    const TableStorage<uint16_t>& symmetryStorage() const { return selfSyms; }
+};
+
+/**
+ * @class SymConjugationTable
+ * @brief A coordinate conjugated by each UD symmetry
+ *
+ * Entry `coord * 16 + sym` holds the coordinate of the conjugate by sym.
+ */
+class SymConjugationTable {
+    TableStorage<uint16_t> conj; ///< Row-major [coordinate][symmetry] conjugates
+
+public:
+    SymConjugationTable() = default;
+
+    /**
+     * @brief Wraps existing conjugates, e.g. loaded from a table file
+     */
+    explicit SymConjugationTable(TableStorage<uint16_t> conj) : conj(std::move(conj)) {}
+
+    /**
+     * @brief Conjugates every coordinate value by every UD symmetry
+     * @param size Number of coordinate values
+     * @param coordOf Maps a CubeState to its coordinate
+     * @param moves Moves that together reach all @p size values from solved
+     * @throws std::logic_error as for SymCoordTable::build
+     *
+     * Like CoordMoveTable::build this relies on the conjugate's coordinate
+     * depending only on the original coordinate.
+     */
+    static SymConjugationTable build(size_t size, uint16_t (*coordOf)(const CubeState&),
+                                     std::span<const RubiksCube::Move> moves);
+
+    /**
+     * @brief Returns coordinate @p coord conjugated by UD symmetry @p sym
+     */
+    uint16_t operator()(size_t coord, size_t sym) const { return conj[coord * kUDSymmetryCount + sym]; }
+
+    /**
+     * @brief Returns the table's memory footprint in bytes
+     */
+    size_t bytes() const { return conj.bytes(); }
+
+    /**
+     * @brief Returns the conjugate array, for writing to a table file
+     */
+    const TableStorage<uint16_t>& storage() const { return conj; }
+};
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef TABLE_FILE_HPP
+#define TABLE_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TableStorage.hpp"
+
+/**
+ * @file TableFile.hpp
+ * @brief Versioned, checksummed on-disk format for solver tables
+ *
+ * A table file holds the tables of one solver back end as consecutive
+ * sections. Layout:
+ * - Header: magic "RCSTABLE", format version, kind of table set, byte-order
+ *   mark, section count, payload size and a checksum of everything after
+ *   the header.
+ * - One descriptor per section: offset, element size and element count.
+ * - Section payloads, each aligned to 64 bytes.
+ *
+ * Files are mapped read-only, so a process starts searching without
+ * copying the tables and several processes share one copy in the page
+ * cache. Any mismatch (version, kind, byte order, geometry or checksum)
+ * makes the file invalid, and it is rebuilt and replaced.
+ */
+
+/// Version of the table file layout and contents; bump whenever either changes
+inline constexpr uint32_t kTableFormatVersion = 3;
+
+/**
+ * @brief Thrown when a table file is missing, unreadable or invalid
+ */
+class TableFileError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @class TableFile
+ * @brief A validated table file mapped into memory
+ */
+class TableFile : public std::enable_shared_from_this<TableFile> {
+    struct Section {
+        uint64_t offset;
+        uint64_t count;
+        uint32_t elementSize;
+    };
+
+    const unsigned char* base = nullptr; ///< Start of the mapping
+    size_t length = 0;                   ///< Size of the mapping in bytes
+    std::vector<unsigned char> buffer;   ///< File contents where mapping is unavailable
+    std::vector<Section> sections;
+
+    TableFile() = default;
+    const void* sectionData(size_t index, size_t elementSize, size_t count) const;
+
+public:
+    TableFile(const TableFile&) = delete;
+    TableFile& operator=(const TableFile&) = delete;
+    ~TableFile();
+
+    /**
+     * @brief Maps and validates a table file
+     * @param path File to open
+     * @param kind Table set the file must hold
+     * @param sectionCount Number of sections the table set has
+     * @throws TableFileError if the file is missing or does not match
+     */
+    static std::shared_ptr<const TableFile> open(const std::string& path, uint32_t kind, size_t sectionCount);
+
+    /**
+     * @brief Returns section @p index as table entries
+     * @param count Number of entries the section must hold
+     * @throws TableFileError if the section has another element size or count
+     */
+    template <typename T>
+    TableStorage<T> section(size_t index, size_t count) const {
+        const T* items = static_cast<const T*>(sectionData(index, sizeof(T), count));
+        return TableStorage<T>(shared_from_this(), items, count);
+    }
+};
+
+/**
+ * @class TableFileWriter
+ * @brief Collects tables and writes them as one table file
+ */
+class TableFileWriter {
+    struct Pending {
+        const void* data;
+        uint64_t count;
+        uint32_t elementSize;
+    };
+
+    uint32_t kind;
+    std::vector<Pending> pending;
+
+public:
+    /**
+     * @param kind Table set being written
+     */
+    explicit TableFileWriter(uint32_t kind) : kind(kind) {}
+
+    /**
+     * @brief Appends a section; the table must stay alive until commit()
+     */
+    template <typename T>
+    void add(const TableStorage<T>& table) {
+        this->pending.push_back({table.data(), table.size(), (uint32_t)sizeof(T)});
+    }
+
+    /**
+     * @brief Writes the file and atomically puts it in place
+     * @throws TableFileError if the file cannot be written
+     *
+     * The data goes to a temporary file in the same directory that is then
+     * flushed to disk and renamed over @p path, so readers see either the
+     * old file or the complete new one, never a partial write, even after
+     * a crash. The directory entry itself is not synced: a crash right
+     * after the rename may bring back the old file.
+     */
+    void commit(const std::string& path) const;
+};
+
+/**
+ * @brief Sets the directory where the shared table instances are cached
+ * @param directory Existing writable directory; empty disables caching
+ *
+ * Must be called before the first solve to take effect. With caching on,
+ * each instance() loads its file from this directory, or builds the tables
+ * and writes the file when it is missing or invalid.
+ */
+void setTableDirectory(const std::string& directory);
+
+/**
+ * @brief Returns the cache file path for a table set, or "" when caching is off
+ */
+std::string tableFilePath(const std::string& name);
+
+/**
+ * @brief Loads a table set from a file, or builds it and replaces the file
+ * @param path Table file; empty just builds the tables
+ * @param options Build options used when the file cannot be loaded
+ *
+ * A failure to write the rebuilt file (e.g. a read-only directory) is not
+ * an error: the built tables are returned and the next process tries again.
+ */
+template <typename Tables, typename Options>
+Tables loadOrBuildTables(const std::string& path, const Options& options) {
+    if (path.empty()) return Tables(options);
+    try {
+        return Tables(TableFile::open(path, Tables::kFileKind, Tables::kFileSections));
+    } catch (const TableFileError&) {
+        // Missing, stale or corrupt; rebuild below
+    }
+    Tables tables(options);
+    try {
+        tables.save(path);
+    } catch (const TableFileError&) {
+    }
+    return tables;
+}
+
+#endif
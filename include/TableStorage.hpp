@@ -0,0 +1,64 @@
+#ifndef TABLE_STORAGE_HPP
+#define TABLE_STORAGE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @file TableStorage.hpp
+ * @brief Read-only table memory that is either owned or memory-mapped
+ */
+
+/**
+ * @class TableStorage
+ * @brief Immutable array of table entries with shared ownership
+ *
+ * The entries live either in a vector filled by a table builder or inside a
+ * mapped table file; lookups go through a plain pointer in both cases. Copies
+ * share the same memory, which stays alive as long as any copy does.
+ */
+template <typename T>
+class TableStorage {
+    std::shared_ptr<const void> owner; ///< Keeps the memory alive: a vector or a mapped file
+    const T* items = nullptr;
+    size_t count = 0;
+
+public:
+    TableStorage() = default;
+
+    /**
+     * @brief Takes ownership of built entries
+     */
+    explicit TableStorage(std::vector<T> values) {
+        auto held = std::make_shared<const std::vector<T>>(std::move(values));
+        this->items = held->data();
+        this->count = held->size();
+        this->owner = std::move(held);
+    }
+
+    /**
+     * @brief Refers to entries kept alive by @p owner, e.g. a mapped file
+     */
+    TableStorage(std::shared_ptr<const void> owner, const T* items, size_t count)
+        : owner(std::move(owner)), items(items), count(count) {}
+
+    const T& operator[](size_t i) const { return items[i]; }
+
+    const T* data() const { return items; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+    /**
+     * @brief Returns the number of entries
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Returns the memory footprint in bytes
+     */
+    size_t bytes() const { return count * sizeof(T); }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef THISTLETHWAITE_SOLVER_HPP
+#define THISTLETHWAITE_SOLVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Coordinates.hpp"
+#include "CubeState.hpp"
+#include "PruningTable.hpp"
+#include "SolveResult.hpp"
+#include "TableFile.hpp"
+
+/**
+ * @file ThistlethwaiteSolver.hpp
+ * @brief Thistlethwaite's four-phase algorithm
+ *
+ * The cube is moved through a chain of nested subgroups, each phase using
+ * fewer move types than the last:
+ * - G0 -> G1: orient all edges; any move.
+ * - G1 -> G2: orient all corners and bring the E-slice edges into the
+ *   E slice; U, D, R, L and F2, B2.
+ * - G2 -> G3: bring every corner into a position reachable by half turns
+ *   and the M-slice edges into the M slice; U, D and R2, L2, F2, B2.
+ * - G3 -> solved: half turns only.
+ *
+ * Every phase has an exact distance table over a coordinate that captures
+ * the whole phase, so each phase is solved optimally by walking downhill
+ * in its table with no search at all. The phases need at most 7, 10, 13
+ * and 15 moves, so solutions never exceed 45 moves.
+ */
+
+/// Distinct states of phase 3: corner permutations times M-edge placements C(8,4)
+inline constexpr size_t kThistlethwaitePhase3Count = kCornerPermCount * 70;
+
+/// Distinct states of phase 4: 96 half-turn corner permutations times 24^3 slice permutations
+inline constexpr size_t kThistlethwaitePhase4Count = 96 * 24 * 24 * 24;
+
+/**
+ * @class ThistlethwaiteTables
+ * @brief Move and distance tables for the four phases (about 7 MB)
+ */
+class ThistlethwaiteTables {
+public:
+    /// Kind tag of Thistlethwaite table files
+    static constexpr uint32_t kFileKind = 0x54485731;  // "THW1"
+
+    /// Tables stored in a file: eight move tables, then the four phase tables
+    static constexpr size_t kFileSections = 12;
+
+    CoordMoveTable flip;            ///< Phase 1: edge flip
+    CoordMoveTable twist;           ///< Phase 2: corner twist
+    CoordMoveTable slice;           ///< Phase 2: E-slice edge positions
+    CoordMoveTable cornerPerm;      ///< Phases 3-4: corner permutation
+    CoordMoveTable mCombo;          ///< Phase 3: M-slice edge positions among the U/D-layer slots
+    CoordMoveTable mPerm;           ///< Phase 4: order of the M-slice edges
+    CoordMoveTable sPerm;           ///< Phase 4: order of the S-slice edges
+    CoordMoveTable ePerm;           ///< Phase 4: order of the E-slice edges
+
+    std::vector<uint16_t> g3Corners;      ///< The 96 corner permutations reachable by half turns
+    std::vector<uint8_t> g3CornerIndex;   ///< Corner permutation -> index in g3Corners, or 0xFF
+
+    PruningTable phase1;            ///< Distance of flip to G1
+    PruningTable phase2;            ///< Distance of (twist, slice) to G2
+    PruningTable phase3;            ///< Distance of (cornerPerm, mCombo) to G3
+    PruningTable phase4;            ///< Distance of (g3 corner, mPerm, sPerm, ePerm) to solved
+
+    /**
+     * @brief Builds every table (takes a fraction of a second)
+     * @param options Threads and progress callback for the distance tables
+     */
+    explicit ThistlethwaiteTables(const TableBuildOptions& options = {});
+
+
+    /**
+     * @brief Maps tables saved by save()
+     * @throws TableFileError if a section does not have the expected geometry
+     */
+    explicit ThistlethwaiteTables(const std::shared_ptr<const TableFile>& file);
+
+    /**
+     * @brief Returns the process-wide tables, built on first use
+     *
+     * If setTableDirectory() was called, the tables are mapped from
+     * "thistlethwaite.tables" there, or built and written to it when the file is
+     * missing or invalid.
+     */
+    static const ThistlethwaiteTables& instance();
+
+    /**
+     * @brief Writes every table to a table file
+     * @throws TableFileError if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Returns the combined memory footprint in bytes
+     */
+    size_t bytes() const;
+};
+
+/**
+ * @brief Solves a cube with Thistlethwaite's algorithm
+ * @param state Valid cube state
+ * @param limits Accepted for a uniform interface but not needed: every solve
+ *               finishes in microseconds with at most 45 moves, whatever
+ *               limits.maxLength says
+ * @param tables Tables to use
+ * @return The solution; stats.nodes counts the table probes made
+ */
+SolveResult solveThistlethwaite(const CubeState& state, const SearchLimits& limits,
+                                const ThistlethwaiteTables& tables = ThistlethwaiteTables::instance());
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file TranspositionTable.hpp
+ * @brief Fixed-size, lock-free cache of distance bounds learned by IDA*
+ *
+ * Move pruning removes redundant move orders such as U D vs D U, but many
+ * states are still reached along several paths of the same length, such as
+ * R2 U2 R2 U2 R2 U2 and U2 R2 U2 R2 U2 R2. When IDA* exhausts the subtree
+ * of a state without finding a solution, it has proved a lower bound on
+ * that state's distance; remembering the bound lets a later visit through
+ * another path skip the subtree at once.
+ */
+
+/**
+ * @brief Which entry of a full bucket a new bound overwrites
+ */
+enum class ReplacementPolicy : uint8_t {
+    Always,         ///< The slot picked by the key, whatever it holds
+    DepthPreferred  ///< The smallest bound in the bucket, since it guards the smallest subtree
+};
+
+/**
+ * @brief Probe statistics of a TranspositionTable
+ */
+struct TranspositionCounters {
+    uint64_t hits = 0;     ///< Probes that found a bound for the key
+    uint64_t misses = 0;   ///< Probes that found nothing
+    uint64_t cutoffs = 0;  ///< Hits whose bound pruned the subtree
+    uint64_t stores = 0;   ///< Bounds written
+
+    TranspositionCounters& operator+=(const TranspositionCounters& other) {
+        this->hits += other.hits;
+        this->misses += other.misses;
+        this->cutoffs += other.cutoffs;
+        this->stores += other.stores;
+        return *this;
+    }
+};
+
+/**
+ * @class TranspositionTable
+ * @brief Lower bounds on the distance of states, keyed by a 64-bit hash
+ *
+ * Entries are grouped in buckets of four that share one 32-byte block, so a
+ * probe costs at most one cache miss. Each entry is a single 64-bit word
+ * holding the upper 56 bits of the key and an 8-bit bound; words are read
+ * and written with relaxed atomics and no lock. A thread may overwrite a
+ * bound another thread just stored, but never sees half of an entry, and
+ * every bound it reads was proved by some search.
+ *
+ * Two different states would have to share a bucket and 56 key bits to be
+ * confused, so a false bound is far less likely than a hardware fault; a
+ * search that cannot tolerate even that should not use the table.
+ *
+ * The bounds depend only on the goal, so one table can serve any number of
+ * solves, concurrent ones included; it keeps improving as they run.
+ */
+class TranspositionTable {
+public:
+    /// Entries per bucket
+    static constexpr size_t kBucketEntries = 4;
+
+    /**
+     * @brief Allocates an empty table
+     * @param bytes Memory budget; the table uses the largest power-of-two
+     *              number of buckets that fits, and at least one
+     * @param policy Replacement policy of full buckets
+     */
+    explicit TranspositionTable(size_t bytes, ReplacementPolicy policy = ReplacementPolicy::DepthPreferred);
+
+    /**
+     * @brief Returns the bound stored for @p key, or 0 if there is none
+     */
+    int lowerBound(uint64_t key) const {
+        const uint64_t tag = key & kTagMask;
+        for (const std::atomic<uint64_t>& entry : this->buckets[key & this->mask].entries) {
+            const uint64_t word = entry.load(std::memory_order_relaxed);
+            if ((word & kTagMask) == tag && word != 0) return (int)(word & ~kTagMask);
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Records that the state of @p key is at least @p bound moves from the goal
+     * @param bound Between 1 and 255
+     *
+     * A bound already stored for the key is only ever raised.
+     */
+    void store(uint64_t key, int bound);
+
+    /**
+     * @brief Starts loading the bucket of @p key into the cache without waiting for it
+     */
+    void prefetch(uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&this->buckets[key & this->mask]);
+#else
+        (void)key;
+#endif
+    }
+
+    /**
+     * @brief Forgets every bound; the counters are kept
+     *
+     * Must not run concurrently with a search using the table.
+     */
+    void clear();
+
+    /**
+     * @brief Adds the probes of one search to the table's counters
+     */
+    void record(const TranspositionCounters& counters);
+
+    /**
+     * @brief Returns the probes recorded since construction or the last resetCounters()
+     */
+    TranspositionCounters counters() const;
+
+    /**
+     * @brief Zeroes the counters
+     */
+    void resetCounters();
+
+    /**
+     * @brief Returns the number of entries
+     */
+    size_t size() const { return this->buckets.size() * kBucketEntries; }
+
+    /**
+     * @brief Returns the table's memory footprint in bytes
+     */
+    size_t bytes() const { return this->buckets.size() * sizeof(Bucket); }
+
+    /**
+     * @brief Returns the replacement policy
+     */
+    ReplacementPolicy policy() const { return this->replacement; }
+
+private:
+    /// Key bits kept in an entry; the low byte holds the bound
+    static constexpr uint64_t kTagMask = ~uint64_t{0xFF};
+
+    struct alignas(32) Bucket {
+        std::atomic<uint64_t> entries[kBucketEntries];
+    };
+
+    std::vector<Bucket> buckets;
+    size_t mask;                  ///< Buckets - 1
+    ReplacementPolicy replacement;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> cutoffs{0};
+    std::atomic<uint64_t> stores{0};
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef TWO_PHASE_SOLVER_HPP
+#define TWO_PHASE_SOLVER_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "Coordinates.hpp"
+#include "CubeState.hpp"
+#include "PruningTable.hpp"
+#include "SolveResult.hpp"
+#include "SymmetryCoordinates.hpp"
+#include "TableFile.hpp"
+
+/**
+ * @file TwoPhaseSolver.hpp
+ * @brief Kociemba's two-phase algorithm
+ *
+ * Phase 1 searches for a move sequence that takes the cube into the
+ * subgroup G1 = <U, D, R2, L2, F2, B2>, where every corner twist and edge
+ * flip is zero and the four UD-slice edges sit in the slice. Phase 2 then
+ * solves the cube using only G1 moves. Both phases are IDA* searches over
+ * coordinates, guided by pruning tables over pairs of coordinates.
+ *
+ * Each phase-1 solution of increasing length is extended by the shortest
+ * phase-2 solution that keeps the total within the length limit, so the
+ * first result is typically close to optimal.
+ */
+
+/**
+ * @class TwoPhaseTables
+ * @brief Move and pruning tables for the two-phase search (about 75 MB)
+ *
+ * All tables are derived from the shared move definitions at construction
+ * and are read-only afterwards, so one instance can serve any number of
+ * concurrent searches.
+ *
+ * The main pruning tables are indexed by symmetry class: phase 1 by the
+ * flip-slice class and the twist, phase 2 by the corner permutation class
+ * and the U/D edge permutation, with the second coordinate conjugated by
+ * the symmetry that takes the first to its class representative. The
+ * 16-fold reduction lets each phase use the distance of the combined
+ * coordinates, a much stronger bound than pairs of smaller coordinates,
+ * in 141 and 112 million entries; stored as distances mod 3 they take
+ * 35 and 28 MB. Two small exact tables over the slice edge order add to
+ * the phase-2 bound.
+ */
+class TwoPhaseTables {
+public:
+    /// Kind tag of two-phase table files
+    static constexpr uint32_t kFileKind = 0x4B4F4331;  // "KOC1"
+
+    /// Tables stored in a file: six move tables, two symmetry classes of three tables each, two
+    /// conjugation tables, then four pruning tables
+    static constexpr size_t kFileSections = 18;
+
+    CoordMoveTable twist;       ///< Corner twist, all moves
+    CoordMoveTable flip;        ///< Edge flip, all moves
+    CoordMoveTable slice;       ///< Unordered slice positions, all moves
+    CoordMoveTable cornerPerm;  ///< Corner permutation, phase-2 moves
+    CoordMoveTable udEdgePerm;  ///< U/D edge permutation, phase-2 moves
+    CoordMoveTable slicePerm;   ///< Slice edge order, phase-2 moves
+
+    SymCoordTable flipSliceSym;           ///< Flip-slice symmetry classes
+    SymCoordTable cornerPermSym;          ///< Corner permutation symmetry classes
+    SymConjugationTable twistConj;        ///< Twist conjugated by each UD symmetry
+    SymConjugationTable udEdgePermConj;   ///< U/D edge permutation conjugated by each UD symmetry
+
+    PruningTable flipSliceTwist;  ///< Phase-1 distance of phase1Index(), mod 3
+    PruningTable cornerEdge;      ///< Phase-2 distance of phase2Index(), mod 3
+    PruningTable cornerSlice;     ///< Phase-2 distance of (cornerPerm, slicePerm)
+    PruningTable edgeSlice;       ///< Phase-2 distance of (udEdgePerm, slicePerm)
+
+    /**
+     * @brief Builds every table (takes several seconds per core)
+     * @param options Threads and progress callback for the distance tables
+     */
+    explicit TwoPhaseTables(const TableBuildOptions& options = {});
+
+
+    /**
+     * @brief Maps tables saved by save()
+     * @throws TableFileError if a section does not have the expected geometry
+     */
+    explicit TwoPhaseTables(const std::shared_ptr<const TableFile>& file);
+
+    /**
+     * @brief Returns the process-wide tables, built on first use
+     *
+     * Initialization is thread-safe; concurrent first callers wait for
+     * the one build.
+     *
+     * If setTableDirectory() was called, the tables are mapped from
+     * "twophase.tables" there, or built and written to it when the file is
+     * missing or invalid.
+     */
+    static const TwoPhaseTables& instance();
+
+    /**
+     * @brief Writes every table to a table file
+     * @throws TableFileError if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Returns the combined memory footprint in bytes
+     */
+    size_t bytes() const;
+
+    /**
+     * @brief Returns the flipSliceTwist index of raw phase-1 coordinates
+     */
+    size_t phase1Index(size_t twist, size_t flip, size_t slice) const {
+        const uint32_t sym = this->flipSliceSym[slice * kFlipCount + flip];
+        return (size_t)(sym >> 4) * kTwistCount + this->twistConj(twist, sym & 15);
+    }
+
+    /**
+     * @brief Returns the cornerEdge index of raw phase-2 coordinates
+     */
+    size_t phase2Index(size_t cornerPerm, size_t udEdgePerm) const {
+        const uint32_t sym = this->cornerPermSym[cornerPerm];
+        return (size_t)(sym >> 4) * kUDEdgePermCount + this->udEdgePermConj(udEdgePerm, sym & 15);
+    }
+};
+
+/// Searches run by solveTwoPhaseAllOrientations: three axes, each on the state and its inverse
+inline constexpr int kTwoPhaseVariants = 6;
+
+/**
+ * @brief State shared by two-phase searches racing on the same cube
+ *
+ * Searches on conjugates and inverses of one state need the same number of
+ * moves, so every racer uses the shortest length found by any of them as its
+ * bound. Setting `cancel` stops every racer at its next clock check.
+ */
+struct TwoPhaseRace {
+    std::atomic<int> bestLength{INT_MAX};  ///< Length of the shortest solution found by any racer
+    std::atomic<bool> cancel{false};       ///< Set once a racer reached the target, or by the caller
+};
+
+/**
+ * @brief Solves a cube with the two-phase algorithm
+ * @param state Valid cube state
+ * @param limits Maximum solution length, target length, deadline and cancel flag
+ * @param onSolution Called with each shorter solution as it is found; may be empty
+ * @param race Bound and cancel flag shared with other searches, or null
+ * @param tables Tables to search with
+ * @return The shortest solution found of at most limits.maxLength moves,
+ *         or an unsolved result if none was found before the deadline
+ *
+ * The search stops at the first solution no longer than limits.targetLength
+ * and until then keeps looking for shorter ones, so with the default target
+ * the first solution within limits.maxLength is returned. With a race the
+ * search only accepts solutions shorter than every racer's, so it may return
+ * unsolved when another racer did better.
+ */
+SolveResult solveTwoPhase(const CubeState& state, const SearchLimits& limits, const SolutionCallback& onSolution = {},
+                          TwoPhaseRace* race = nullptr, const TwoPhaseTables& tables = TwoPhaseTables::instance());
+
+/**
+ * @brief Races six two-phase searches on one cube, one thread each
+ * @param state Valid cube state
+ * @param limits Maximum solution length, target length, deadline and cancel flag
+ * @param onSolution Called with each solution shorter than all before it,
+ *                   already mapped back to @p state; calls are serialized
+ *                   but come from the racing threads
+ * @param tables Tables to search with
+ * @return The shortest solution of any search, mapped back to @p state;
+ *         stats.nodes sums the work of all six
+ *
+ * The searches run on the state seen along each of the three URF axes and
+ * on the inverse of each. Where one variant stalls in phase 1 another often
+ * finds a short phase-1 path at once, so the race finds shorter solutions
+ * sooner than one search. Every solution tightens the shared bound, and the
+ * first one within the target length cancels the rest.
+ */
+SolveResult solveTwoPhaseAllOrientations(const CubeState& state, const SearchLimits& limits,
+                                         const SolutionCallback& onSolution = {},
+                                         const TwoPhaseTables& tables = TwoPhaseTables::instance());
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @file WorkStealing.hpp
+ * @brief Work-stealing execution of a fixed set of independent tasks
+ */
+
+/**
+ * @brief Runs fn(task, worker) for every task in [0, count) on several threads
+ * @param count Number of tasks
+ * @param workers Number of threads to use, including the calling thread
+ * @param fn Task body; invoked concurrently from different workers
+ *
+ * Each worker starts with a contiguous block of task indices and takes them
+ * in increasing order, so with one worker the tasks run in index order.
+ * A worker that runs dry steals the upper half of the largest remaining
+ * block of another worker, which keeps every thread busy when task costs
+ * vary by orders of magnitude, as subtrees of a search do. Returns once
+ * every task has finished.
+ */
+void runWorkStealing(size_t count, unsigned workers, const std::function<void(size_t task, unsigned worker)>& fn);
+
+#endif
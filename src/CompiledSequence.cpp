@@ -0,0 +1,54 @@
+/**
+ * @file CompiledSequence.cpp
+ * @brief Folding of move sequences into single permutations
+ */
+
+#include "../include/CompiledSequence.hpp"
+#include "../include/MoveSequence.hpp"
+#include <stdexcept>
+
+CompiledSequence::CompiledSequence()
+    : def(identityMove()), moveCount(0) {}
+
+CompiledSequence::CompiledSequence(const std::string& moves)
+    : CompiledSequence() {
+    // Parse once; every later application reuses the folded permutation
+    const ParseResult result = forEachMove(moves, [this](RubiksCube::Move m) {
+        this->def = composeMoves(this->def, moveDefinition(m));
+        ++this->moveCount;
+    });
+    if (!result) {
+        throw std::invalid_argument("Invalid move at position " + std::to_string(result.position) +
+                                    ": " + parseErrorMessage(result.error));
+    }
+}
+
+CompiledSequence::CompiledSequence(const MoveSequence& moves)
+    : CompiledSequence() {
+    for (size_t i = 0; i < moves.size(); ++i) {
+        this->def = composeMoves(this->def, moveDefinition(moves[i]));
+    }
+    this->moveCount = moves.size();
+}
+
+CompiledSequence::CompiledSequence(std::span<const RubiksCube::Move> moves)
+    : CompiledSequence() {
+    for (RubiksCube::Move m : moves) {
+        this->def = composeMoves(this->def, moveDefinition(m));
+    }
+    this->moveCount = moves.size();
+}
+
+CompiledSequence CompiledSequence::then(const CompiledSequence& next) const {
+    CompiledSequence r;
+    r.def = composeMoves(this->def, next.def);
+    r.moveCount = this->moveCount + next.moveCount;
+    return r;
+}
+
+CompiledSequence CompiledSequence::inverse() const {
+    CompiledSequence r;
+    r.def = inverseMove(this->def);
+    r.moveCount = this->moveCount;
+    return r;
+}
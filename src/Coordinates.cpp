@@ -0,0 +1,128 @@
+/**
+ * @file Coordinates.cpp
+ * @brief Coordinate functions and breadth-first construction of move tables
+ */
+
+#include "../include/Coordinates.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace {
+    /**
+     * @brief Binomial coefficient C(n, k) for the small arguments used here
+     */
+    constexpr int choose(int n, int k) {
+        if (k < 0 || k > n) return 0;
+        int r = 1;
+        for (int i = 0; i < k; ++i) r = r * (n - i) / (i + 1);
+        return r;
+    }
+
+    /**
+     * @brief Lehmer-style rank of a permutation of pieces 0..N-1
+     *
+     * Repeatedly rotates the prefix until the highest remaining piece is in
+     * its home slot; the rotation counts are the digits of a mixed-radix
+     * number. This is Kociemba's numbering, with the identity ranked 0.
+     */
+    template <int N>
+    uint16_t permutationRank(std::array<uint8_t, N> perm) {
+        int rank = 0;
+        for (int j = N - 1; j > 0; --j) {
+            int k = 0;
+            while (perm[j] != j) {
+                const uint8_t first = perm[0];
+                for (int i = 0; i < j; ++i) perm[i] = perm[i + 1];
+                perm[j] = first;
+                ++k;
+            }
+            rank = (j + 1) * rank + k;
+        }
+        return (uint16_t)rank;
+    }
+}
+
+uint16_t twistCoord(const CubeState& s) {
+    int r = 0;
+    for (int i = 0; i < 7; ++i) r = 3 * r + s.cornerOrientation(i);
+    return (uint16_t)r;
+}
+
+uint16_t flipCoord(const CubeState& s) {
+    int r = 0;
+    for (int i = 0; i < 11; ++i) r = 2 * r + s.edgeOrientation(i);
+    return (uint16_t)r;
+}
+
+uint16_t sliceSortedCoord(const CubeState& s) {
+    // Positions: scan slots from BR down to UR, ranking the occupied set
+    std::array<uint8_t, 4> order{};
+    int a = 0, x = 0;
+    for (int j = 11; j >= 0; --j) {
+        const uint8_t piece = s.edgePiece(j);
+        if (piece >= 8) {
+            a += choose(11 - j, x + 1);
+            order[3 - x] = (uint8_t)(piece - 8);
+            ++x;
+        }
+    }
+    // Order: rank the slice edges in the order they were met
+    return (uint16_t)(24 * a + permutationRank<4>(order));
+}
+
+uint16_t sliceCoord(const CubeState& s) {
+    return (uint16_t)(sliceSortedCoord(s) / 24);
+}
+
+uint16_t slicePermCoord(const CubeState& s) {
+    return (uint16_t)(sliceSortedCoord(s) % 24);
+}
+
+uint16_t cornerPermCoord(const CubeState& s) {
+    std::array<uint8_t, 8> perm{};
+    for (int i = 0; i < 8; ++i) perm[i] = s.cornerPiece(i);
+    return permutationRank<8>(perm);
+}
+
+uint16_t udEdgePermCoord(const CubeState& s) {
+    std::array<uint8_t, 8> perm{};
+    for (int i = 0; i < 8; ++i) perm[i] = s.edgePiece(i);
+    return permutationRank<8>(perm);
+}
+
+CoordMoveTable CoordMoveTable::build(size_t size, uint16_t (*coordOf)(const CubeState&),
+                                     std::span<const RubiksCube::Move> moves) {
+    std::vector<uint16_t> next(size * kMoveCount, kInvalid);
+
+    // Breadth-first walk keeping the first state seen for each coordinate
+    std::vector<CubeState> representative(size);
+    std::vector<uint8_t> seen(size, 0);
+    std::vector<uint16_t> queue;
+    queue.reserve(size);
+
+    const CubeState solved = CubeState::solved();
+    const uint16_t start = coordOf(solved);
+    representative[start] = solved;
+    seen[start] = 1;
+    queue.push_back(start);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint16_t c = queue[head];
+        for (RubiksCube::Move m : moves) {
+            const CubeState child = representative[c].moved(m);
+            const uint16_t cc = coordOf(child);
+            if (cc >= size) throw std::logic_error("Coordinate out of range: " + std::to_string(cc));
+            next[c * kMoveCount + static_cast<size_t>(m)] = cc;
+            if (!seen[cc]) {
+                seen[cc] = 1;
+                representative[cc] = child;
+                queue.push_back(cc);
+            }
+        }
+    }
+    if (queue.size() != size) {
+        throw std::logic_error("Coordinate move table reached " + std::to_string(queue.size()) +
+                               " of " + std::to_string(size) + " values");
+    }
+    return CoordMoveTable(TableStorage<uint16_t>(std::move(next)));
+}
@@ -0,0 +1,314 @@
+/**
+ * @file CubeBatch.cpp
+ * @brief Structure-of-arrays move kernels for CubeBatch
+ *
+ * Rows hold one packed cubie byte per cube (see CubeBatch.hpp). A move
+ * applied to every cube rewrites only the 8 rows whose slots it touches: each
+ * new row is an old row plus a per-row orientation delta, reduced with the
+ * same subtract/min trick PackedCube uses. Per-cube moves blend the candidate
+ * rows of every move under lane masks. The AVX2 kernels work on 32 cubes per
+ * register; the portable same-move kernel uses fixed 32-byte loops that
+ * compile to SSE2, and the portable per-cube kernel works lane by lane.
+ */
+
+#include "../include/CubeBatch.hpp"
+#include "../include/CompiledSequence.hpp"
+#include "../include/MoveTables.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    /**
+     * @brief Row-level description of one move
+     */
+    struct BatchMove {
+        std::array<uint8_t, CubeBatch::kRows> source; ///< Row each row reads from
+        std::array<uint8_t, CubeBatch::kRows> delta;  ///< Orientation delta, pre-shifted into bits 4-5
+        std::array<uint8_t, CubeBatch::kRows> moved;  ///< Rows the move changes (first movedCount entries)
+        uint8_t movedCount;                           ///< Number of valid entries in moved
+    };
+
+    /**
+     * @brief Translates a slot-level move definition into row operations
+     */
+    constexpr BatchMove toBatchMove(const MoveDef& def) {
+        BatchMove bm{};
+        for (int i = 0; i < 8; ++i) {
+            bm.source[i] = def.corner_perm[i];
+            bm.delta[i] = (uint8_t)(def.corner_ori_delta[i] << 4);
+        }
+        for (int i = 0; i < 12; ++i) {
+            bm.source[8 + i] = (uint8_t)(8 + def.edge_perm[i]);
+            bm.delta[8 + i] = (uint8_t)(def.edge_ori_delta[i] << 4);
+        }
+        for (uint8_t r = 0; r < CubeBatch::kRows; ++r) {
+            if (bm.source[r] != r || bm.delta[r] != 0) bm.moved[bm.movedCount++] = r;
+        }
+        return bm;
+    }
+
+    constexpr std::array<BatchMove, 18> buildBatchMoves() {
+        std::array<BatchMove, 18> table{};
+        for (size_t m = 0; m < table.size(); ++m) {
+            table[m] = toBatchMove(g_moveTables[m]);
+        }
+        return table;
+    }
+
+    /// Row-level move tables indexed by RubiksCube::Move
+    constexpr std::array<BatchMove, 18> g_batchMoves = buildBatchMoves();
+
+    /**
+     * @brief One way a row can change: under @c move it reads @c source plus @c delta
+     */
+    struct RowEntry {
+        uint8_t move;
+        uint8_t source;
+        uint8_t delta;
+    };
+
+    /**
+     * @brief For each row, the moves that change it (at most 9 for a corner row)
+     */
+    struct RowEntries {
+        std::array<RowEntry, 9> entries;
+        uint8_t count;
+    };
+
+    constexpr std::array<RowEntries, CubeBatch::kRows> buildRowEntries() {
+        std::array<RowEntries, CubeBatch::kRows> table{};
+        for (uint8_t m = 0; m < 18; ++m) {
+            const BatchMove& bm = g_batchMoves[m];
+            for (size_t j = 0; j < bm.movedCount; ++j) {
+                const uint8_t r = bm.moved[j];
+                table[r].entries[table[r].count++] = RowEntry{m, bm.source[r], bm.delta[r]};
+            }
+        }
+        return table;
+    }
+
+    /// Per-row inverse of g_batchMoves, used by the per-lane kernels
+    constexpr std::array<RowEntries, CubeBatch::kRows> g_rowEntries = buildRowEntries();
+
+    /// Orientation modulus of a row, pre-shifted into bits 4-5
+    constexpr uint8_t rowModulus(size_t row) {
+        return row < 8 ? 0x30 : 0x20;
+    }
+
+    /// Lanes per cache block for the same-move kernel
+    constexpr size_t kBlock = 256;
+
+    /**
+     * @brief Row length for a batch: count rounded up to whole SIMD chunks
+     *
+     * Rows whose length is a multiple of 4 KiB would make the same lane of
+     * every row share address bits 0-11, so loads from one row falsely wait
+     * on stores to another (4K aliasing). Such strides get one extra chunk.
+     */
+    constexpr size_t paddedStride(size_t count) {
+        const size_t stride = (count + CubeBatch::kLanes - 1) / CubeBatch::kLanes * CubeBatch::kLanes;
+        return stride % 4096 == 0 ? stride + CubeBatch::kLanes : stride;
+    }
+
+#if defined(__AVX2__)
+    inline __m256i reduce(__m256i t, __m256i mod) {
+        return _mm256_min_epu8(t, _mm256_sub_epi8(t, mod));
+    }
+
+    /**
+     * @brief Candidate value of row entry J of row R, with its delta applied
+     */
+    template <size_t R, size_t J>
+    inline __m256i candidate(const __m256i* in) {
+        constexpr RowEntry e = g_rowEntries[R].entries[J];
+        if constexpr (e.delta != 0) {
+            return _mm256_add_epi8(in[e.source], _mm256_set1_epi8((char)e.delta));
+        } else {
+            return in[e.source];
+        }
+    }
+
+    /**
+     * @brief Computes one output row of the per-lane kernel
+     *
+     * Fully unrolled at compile time so every source row, delta and mask index
+     * is a constant and the blend chain stays in registers.
+     */
+    template <size_t R, size_t... J>
+    inline __m256i blendRow(const __m256i* in, const __m256i* masks, std::index_sequence<J...>) {
+        __m256i acc = in[R];
+        ((acc = _mm256_blendv_epi8(acc, candidate<R, J>(in), masks[g_rowEntries[R].entries[J].move])), ...);
+        return reduce(acc, _mm256_set1_epi8((char)rowModulus(R)));
+    }
+
+    template <size_t... R>
+    inline void blendRows(const __m256i* in, const __m256i* masks, __m256i* out, std::index_sequence<R...>) {
+        ((out[R] = blendRow<R>(in, masks, std::make_index_sequence<g_rowEntries[R].count>{})), ...);
+    }
+#endif
+}
+
+CubeBatch::CubeBatch(size_t count)
+    : count(count),
+      stride(paddedStride(count)),
+      rows(kRows * stride) {
+    reset();
+}
+
+CubeBatch CubeBatch::fromCubes(std::span<const RubiksCube> cubes) {
+    CubeBatch batch(cubes.size());
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        batch.set(i, cubes[i]);
+    }
+    return batch;
+}
+
+void CubeBatch::reset() {
+    // Row r holds piece r with orientation 0 (edge rows hold r - 8)
+    for (size_t r = 0; r < kRows; ++r) {
+        const uint8_t solved = (uint8_t)(r < 8 ? r : r - 8);
+        std::fill_n(this->rows.begin() + r * stride, stride, solved);
+    }
+}
+
+void CubeBatch::set(size_t lane, const RubiksCube& cube) {
+    for (int i = 0; i < 8; ++i) {
+        this->rows[i * stride + lane] = (uint8_t)(cube.cornerPiece(i) | (cube.cornerOrientation(i) << 4));
+    }
+    for (int i = 0; i < 12; ++i) {
+        this->rows[(8 + i) * stride + lane] = (uint8_t)(cube.edgePiece(i) | (cube.edgeOrientation(i) << 4));
+    }
+}
+
+RubiksCube CubeBatch::get(size_t lane) const {
+    RubiksCube cube;
+    for (int i = 0; i < 8; ++i) {
+        const uint8_t b = this->rows[i * stride + lane];
+        cube.setCorner(i, b & 0x0F, b >> 4);
+    }
+    for (int i = 0; i < 12; ++i) {
+        const uint8_t b = this->rows[(8 + i) * stride + lane];
+        cube.setEdge(i, b & 0x0F, b >> 4);
+    }
+    return cube;
+}
+
+bool CubeBatch::isSolved(size_t lane) const {
+    for (size_t r = 0; r < kRows; ++r) {
+        const uint8_t solved = (uint8_t)(r < 8 ? r : r - 8);
+        if (this->rows[r * stride + lane] != solved) return false;
+    }
+    return true;
+}
+
+namespace {
+    /**
+     * @brief Applies one row-level move to every lane of a batch
+     * @param rows First byte of row 0
+     * @param stride Row length in bytes (a multiple of kLanes)
+     * @param bm Rows to rewrite, their sources and orientation deltas
+     */
+    void applyRowMove(uint8_t* rows, size_t stride, const BatchMove& bm) {
+        // Work block by block so the saved source rows stay in L1. Only rows the
+        // move changes are saved and rewritten; the others are left untouched.
+        alignas(32) uint8_t saved[CubeBatch::kRows][kBlock];
+        for (size_t base = 0; base < stride; base += kBlock) {
+            const size_t width = std::min(kBlock, stride - base);
+            for (size_t j = 0; j < bm.movedCount; ++j) {
+                const size_t r = bm.moved[j];
+                std::copy_n(rows + r * stride + base, width, saved[r]);
+            }
+
+            for (size_t j = 0; j < bm.movedCount; ++j) {
+                const size_t r = bm.moved[j];
+                const uint8_t* src = saved[bm.source[r]];
+                uint8_t* dst = rows + r * stride + base;
+#if defined(__AVX2__)
+                const __m256i delta = _mm256_set1_epi8((char)bm.delta[r]);
+                const __m256i mod = _mm256_set1_epi8((char)rowModulus(r));
+                for (size_t k = 0; k < width; k += CubeBatch::kLanes) {
+                    const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(src + k));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + k), reduce(_mm256_add_epi8(v, delta), mod));
+                }
+#else
+                const uint8_t delta = bm.delta[r];
+                const uint8_t mod = rowModulus(r);
+                for (size_t k = 0; k < width; k += CubeBatch::kLanes) {
+                    for (size_t l = 0; l < CubeBatch::kLanes; ++l) {
+                        const uint8_t t = (uint8_t)(src[k + l] + delta);
+                        const uint8_t reduced = (uint8_t)(t - mod);
+                        dst[k + l] = reduced < t ? reduced : t;
+                    }
+                }
+#endif
+            }
+        }
+    }
+}
+
+void CubeBatch::applyMove(RubiksCube::Move move) {
+    applyRowMove(this->rows.data(), stride, g_batchMoves[static_cast<size_t>(move)]);
+}
+
+void CubeBatch::applySequence(const CompiledSequence& sequence) {
+    applyRowMove(this->rows.data(), stride, toBatchMove(sequence.definition()));
+}
+
+void CubeBatch::applyMoves(std::span<const RubiksCube::Move> moves) {
+    if (moves.size() != count) {
+        throw std::invalid_argument("CubeBatch::applyMoves: expected one move per cube");
+    }
+
+    // Each chunk of 32 cubes is processed row by row. Every output row starts
+    // as its current value and, for each move that changes it, blends in the
+    // moved source row (plus orientation delta) under the mask of lanes making
+    // that move. Orientations are reduced once at the end of the row.
+    for (size_t base = 0; base < stride; base += kLanes) {
+        alignas(32) uint8_t moveIds[kLanes];
+        for (size_t l = 0; l < kLanes; ++l) {
+            // Padding lanes get an out-of-range id so no move selects them
+            moveIds[l] = base + l < count ? (uint8_t)moves[base + l] : 0xFF;
+        }
+
+#if defined(__AVX2__)
+        const __m256i ids = _mm256_load_si256(reinterpret_cast<const __m256i*>(moveIds));
+        __m256i masks[18];
+        for (int m = 0; m < 18; ++m) {
+            masks[m] = _mm256_cmpeq_epi8(ids, _mm256_set1_epi8((char)m));
+        }
+        __m256i in[kRows];
+        for (size_t r = 0; r < kRows; ++r) {
+            in[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(this->rows.data() + r * stride + base));
+        }
+        __m256i out[kRows];
+        blendRows(in, masks, out, std::make_index_sequence<kRows>{});
+        for (size_t r = 0; r < kRows; ++r) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(this->rows.data() + r * stride + base), out[r]);
+        }
+#else
+        // Without AVX2, blending all candidates costs more than it saves, so
+        // each lane applies its own move to the 8 rows it changes.
+        uint8_t* chunk = this->rows.data() + base;
+        for (size_t l = 0; l < kLanes; ++l) {
+            if (moveIds[l] == 0xFF) continue;
+            const BatchMove& bm = g_batchMoves[moveIds[l]];
+            uint8_t saved[kRows];
+            for (size_t j = 0; j < bm.movedCount; ++j) {
+                saved[bm.moved[j]] = chunk[bm.moved[j] * stride + l];
+            }
+            for (size_t j = 0; j < bm.movedCount; ++j) {
+                const size_t r = bm.moved[j];
+                const uint8_t t = (uint8_t)(saved[bm.source[r]] + bm.delta[r]);
+                const uint8_t reduced = (uint8_t)(t - rowModulus(r));
+                chunk[r * stride + l] = reduced < t ? reduced : t;
+            }
+        }
+#endif
+    }
+}
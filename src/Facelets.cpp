@@ -0,0 +1,251 @@
+/**
+ * @file Facelets.cpp
+ * @brief Facelet string conversion backed by precomputed sticker maps
+ *
+ * Each corner and edge slot owns a fixed set of facelet positions. Reading
+ * the face colours at those positions, in a fixed order, identifies both the
+ * piece and its orientation, so a single table lookup per slot replaces the
+ * usual search over pieces and orientations.
+ */
+
+#include "../include/Facelets.hpp"
+
+namespace {
+    /// Faces in facelet-string order
+    enum Face : uint8_t { U, R, F, D, L, B };
+
+    /**
+     * @brief Facelet positions of each corner slot
+     *
+     * The U/D sticker comes first, followed by the other two clockwise.
+     */
+    constexpr uint8_t g_cornerFacelet[8][3] = {
+        {8, 9, 20},   // URF
+        {6, 18, 38},  // UFL
+        {0, 36, 47},  // ULB
+        {2, 45, 11},  // UBR
+        {29, 26, 15}, // DFR
+        {27, 44, 24}, // DLF
+        {33, 53, 42}, // DBL
+        {35, 17, 51}  // DRB
+    };
+
+    /// Facelet positions of each edge slot, reference sticker first
+    constexpr uint8_t g_edgeFacelet[12][2] = {
+        {5, 10}, {7, 19}, {3, 37}, {1, 46},   // UR UF UL UB
+        {32, 16}, {28, 25}, {30, 43}, {34, 52}, // DR DF DL DB
+        {23, 12}, {21, 41}, {50, 39}, {48, 14}  // FR FL BL BR
+    };
+
+    /// Face colours of each corner piece in the same order as g_cornerFacelet
+    constexpr uint8_t g_cornerColor[8][3] = {
+        {U, R, F}, {U, F, L}, {U, L, B}, {U, B, R},
+        {D, F, R}, {D, L, F}, {D, B, L}, {D, R, B}
+    };
+
+    /// Face colours of each edge piece in the same order as g_edgeFacelet
+    constexpr uint8_t g_edgeColor[12][2] = {
+        {U, R}, {U, F}, {U, L}, {U, B},
+        {D, R}, {D, F}, {D, L}, {D, B},
+        {F, R}, {F, L}, {B, L}, {B, R}
+    };
+
+    /// Sticker letter written for each face
+    constexpr char g_faceLetter[6] = {
+        static_cast<char>(Color::W), static_cast<char>(Color::R), static_cast<char>(Color::G),
+        static_cast<char>(Color::Y), static_cast<char>(Color::O), static_cast<char>(Color::B)
+    };
+
+    constexpr uint8_t kInvalid = 0xFF;
+
+    /**
+     * @brief Maps every byte to the index of its Color letter (0-5) or kInvalid
+     */
+    constexpr std::array<uint8_t, 256> buildColorIndex() {
+        std::array<uint8_t, 256> table{};
+        table.fill(kInvalid);
+        for (uint8_t f = 0; f < 6; ++f) table[(uint8_t)g_faceLetter[f]] = f;
+        return table;
+    }
+
+    /**
+     * @brief Maps three face colours read at a corner slot to `piece | (ori << 4)`
+     *
+     * The key is `36 * c0 + 6 * c1 + c2` for the colours at the slot's
+     * positions 0, 1, 2. A piece with twist o shows its colour n at position
+     * (n + o) % 3, which does not depend on the slot.
+     */
+    constexpr std::array<uint8_t, 216> buildCornerLookup() {
+        std::array<uint8_t, 216> table{};
+        table.fill(kInvalid);
+        for (uint8_t j = 0; j < 8; ++j) {
+            for (uint8_t o = 0; o < 3; ++o) {
+                const int key = 36 * g_cornerColor[j][(3 - o) % 3] +
+                                6 * g_cornerColor[j][(4 - o) % 3] +
+                                g_cornerColor[j][(5 - o) % 3];
+                table[key] = (uint8_t)(j | (o << 4));
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief Maps two face colours read at an edge slot to `piece | (ori << 4)`
+     */
+    constexpr std::array<uint8_t, 36> buildEdgeLookup() {
+        std::array<uint8_t, 36> table{};
+        table.fill(kInvalid);
+        for (uint8_t j = 0; j < 12; ++j) {
+            table[6 * g_edgeColor[j][0] + g_edgeColor[j][1]] = j;
+            table[6 * g_edgeColor[j][1] + g_edgeColor[j][0]] = (uint8_t)(j | 0x10);
+        }
+        return table;
+    }
+
+    constexpr std::array<uint8_t, 256> g_colorIndex = buildColorIndex();
+    constexpr std::array<uint8_t, 216> g_cornerLookup = buildCornerLookup();
+    constexpr std::array<uint8_t, 36> g_edgeLookup = buildEdgeLookup();
+
+    /**
+     * @brief Converts one record whose length has already been checked
+     */
+    StateError convert(const char* facelets, CubeState& out) {
+        // Centres decide which colour belongs to which face
+        uint8_t colorToFace[6] = {kInvalid, kInvalid, kInvalid, kInvalid, kInvalid, kInvalid};
+        for (uint8_t f = 0; f < 6; ++f) {
+            const uint8_t c = g_colorIndex[(uint8_t)facelets[9 * f + 4]];
+            if (c == kInvalid || colorToFace[c] != kInvalid) return StateError::InvalidCenter;
+            colorToFace[c] = f;
+        }
+
+        uint8_t face[kFaceletCount];
+        for (size_t i = 0; i < kFaceletCount; ++i) {
+            const uint8_t c = g_colorIndex[(uint8_t)facelets[i]];
+            if (c == kInvalid) return StateError::InvalidColor;
+            face[i] = colorToFace[c];
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            const uint8_t* p = g_cornerFacelet[i];
+            const uint8_t v = g_cornerLookup[36 * face[p[0]] + 6 * face[p[1]] + face[p[2]]];
+            if (v == kInvalid) return StateError::InvalidCorner;
+            out.corners[i] = v;
+        }
+        for (int i = 0; i < 12; ++i) {
+            const uint8_t* p = g_edgeFacelet[i];
+            const uint8_t v = g_edgeLookup[6 * face[p[0]] + face[p[1]]];
+            if (v == kInvalid) return StateError::InvalidEdge;
+            out.edges[i] = v;
+        }
+        return validateState(out);
+    }
+
+    /**
+     * @brief Returns the parity (0 even, 1 odd) of a permutation by counting inversions
+     */
+    template <size_t N>
+    int permutationParity(const std::array<uint8_t, N>& slots) {
+        int inversions = 0;
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = i + 1; j < N; ++j) {
+                inversions += (slots[i] & 0x0F) > (slots[j] & 0x0F);
+            }
+        }
+        return inversions & 1;
+    }
+}
+
+const char* stateErrorMessage(StateError error) {
+    switch (error) {
+        case StateError::None: return "no error";
+        case StateError::InvalidLength: return "expected 54 facelets";
+        case StateError::InvalidColor: return "facelet is not a centre colour";
+        case StateError::InvalidCenter: return "centres must be six distinct colours";
+        case StateError::InvalidCorner: return "corner colours match no corner piece";
+        case StateError::InvalidEdge: return "edge colours match no edge piece";
+        case StateError::DuplicateCorner: return "corner piece missing or repeated";
+        case StateError::DuplicateEdge: return "edge piece missing or repeated";
+        case StateError::TwistError: return "corner twists do not cancel";
+        case StateError::FlipError: return "edge flips do not cancel";
+        case StateError::ParityError: return "corner and edge permutation parities differ";
+    }
+    return "unknown error";
+}
+
+StateError validateState(const CubeState& state) {
+    unsigned seen = 0;
+    int twist = 0;
+    for (int i = 0; i < 8; ++i) {
+        const uint8_t piece = state.cornerPiece(i);
+        const uint8_t ori = state.cornerOrientation(i);
+        if (piece >= 8) return StateError::DuplicateCorner;
+        if (ori >= 3) return StateError::TwistError;
+        seen |= 1u << piece;
+        twist += ori;
+    }
+    if (seen != 0xFFu) return StateError::DuplicateCorner;
+
+    seen = 0;
+    int flip = 0;
+    for (int i = 0; i < 12; ++i) {
+        const uint8_t piece = state.edgePiece(i);
+        const uint8_t ori = state.edgeOrientation(i);
+        if (piece >= 12) return StateError::DuplicateEdge;
+        if (ori >= 2) return StateError::FlipError;
+        seen |= 1u << piece;
+        flip += ori;
+    }
+    if (seen != 0xFFFu) return StateError::DuplicateEdge;
+
+    if (twist % 3 != 0) return StateError::TwistError;
+    if (flip % 2 != 0) return StateError::FlipError;
+    if (permutationParity(state.corners) != permutationParity(state.edges)) return StateError::ParityError;
+    return StateError::None;
+}
+
+StateError fromFacelets(std::string_view facelets, CubeState& out) {
+    if (facelets.size() != kFaceletCount) return StateError::InvalidLength;
+    return convert(facelets.data(), out);
+}
+
+void toFacelets(const CubeState& state, char* out) {
+    for (int f = 0; f < 6; ++f) out[9 * f + 4] = g_faceLetter[f];
+    for (int i = 0; i < 8; ++i) {
+        const uint8_t j = state.cornerPiece(i);
+        const uint8_t o = state.cornerOrientation(i);
+        for (int n = 0; n < 3; ++n) {
+            out[g_cornerFacelet[i][(n + o) % 3]] = g_faceLetter[g_cornerColor[j][n]];
+        }
+    }
+    for (int i = 0; i < 12; ++i) {
+        const uint8_t j = state.edgePiece(i);
+        const uint8_t o = state.edgeOrientation(i);
+        for (int n = 0; n < 2; ++n) {
+            out[g_edgeFacelet[i][(n + o) % 2]] = g_faceLetter[g_edgeColor[j][n]];
+        }
+    }
+}
+
+size_t fromFaceletsBulk(std::string_view text, size_t stride,
+                        std::span<CubeState> out, std::span<StateError> status) {
+    size_t valid = 0;
+    const size_t n = out.size() < status.size() ? out.size() : status.size();
+    for (size_t i = 0; i < n; ++i) {
+        const size_t offset = i * stride;
+        if (stride < kFaceletCount || offset > text.size() || text.size() - offset < kFaceletCount) {
+            status[i] = StateError::InvalidLength;
+            continue;
+        }
+        status[i] = convert(text.data() + offset, out[i]);
+        valid += status[i] == StateError::None;
+    }
+    return valid;
+}
+
+void toFaceletsBulk(std::span<const CubeState> states, char* out, size_t stride) {
+    for (size_t i = 0; i < states.size(); ++i) {
+        char* record = out + i * stride;
+        toFacelets(states[i], record);
+        for (size_t k = kFaceletCount; k < stride; ++k) record[k] = '\n';
+    }
+}
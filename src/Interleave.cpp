@@ -0,0 +1,50 @@
+/**
+ * @file Interleave.cpp
+ * @brief Round-robin scheduler for interleaved coroutine searches
+ */
+
+#include "../include/Interleave.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+void runInterleaved(size_t count, unsigned workers, size_t width, const std::function<InterleavedTask(size_t task)>& make) {
+    workers = (unsigned)std::max<size_t>(1, std::min<size_t>(workers, count));
+    width = std::max<size_t>(1, width);
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex errorLock;
+    std::exception_ptr error;
+
+    auto work = [&] {
+        std::vector<InterleavedTask> slots(width);
+        try {
+            bool running = true;
+            while (running) {
+                running = false;
+                for (InterleavedTask& slot : slots) {
+                    if (!slot.active()) {
+                        const size_t task = failed.load(std::memory_order_relaxed)
+                            ? count : next.fetch_add(1, std::memory_order_relaxed);
+                        if (task >= count) continue;
+                        slot = make(task);
+                    }
+                    slot.resume();
+                    running = true;
+                }
+            }
+        } catch (...) {
+            failed.store(true, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned w = 1; w < workers; ++w) threads.emplace_back(work);
+    work();
+    for (std::thread& th : threads) th.join();
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,58 @@
+/**
+ * @file MoveSequence.cpp
+ * @brief Parsing and serialization of packed move sequences
+ */
+
+#include "../include/MoveSequence.hpp"
+#include "../include/MoveTables.hpp"
+#include <cstring>
+
+const char* parseErrorMessage(ParseError error) {
+    switch (error) {
+        case ParseError::None: return "no error";
+        case ParseError::InvalidFace: return "expected one of U, D, R, L, F, B";
+        case ParseError::InvalidSuffix: return "expected ', 2 or whitespace after face";
+        case ParseError::TooLong: return "too many moves";
+    }
+    return "unknown error";
+}
+
+ParseResult MoveSequence::parse(std::string_view text, MoveSequence& out) {
+    out.clear();
+    return forEachMove(text, [&](RubiksCube::Move m) {
+        return out.push_back(m) ? ParseError::None : ParseError::TooLong;
+    });
+}
+
+MoveSequence MoveSequence::inverse() const {
+    // Within a face, the variants are ordered quarter, prime, double
+    static constexpr uint8_t inverseVariant[3] = {1, 0, 2};
+    MoveSequence r;
+    for (size_t i = this->count; i-- > 0;) {
+        const int m = static_cast<int>((*this)[i]);
+        r.push_back(static_cast<RubiksCube::Move>(m - m % 3 + inverseVariant[m % 3]));
+    }
+    return r;
+}
+
+size_t MoveSequence::write(char* buffer, size_t capacity) const {
+    size_t len = 0;
+    for (size_t i = 0; i < this->count; ++i) {
+        const char* name = g_moveNames[static_cast<size_t>((*this)[i])];
+        const size_t n = std::strlen(name);
+        if (i > 0) {
+            if (len < capacity) buffer[len] = ' ';
+            ++len;
+        }
+        for (size_t k = 0; k < n; ++k, ++len) {
+            if (len < capacity) buffer[len] = name[k];
+        }
+    }
+    return len;
+}
+
+std::string MoveSequence::toString() const {
+    char buffer[maxTextLength(kCapacity)];
+    const size_t len = write(buffer, sizeof(buffer));
+    return std::string(buffer, len);
+}
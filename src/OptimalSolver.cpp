@@ -0,0 +1,699 @@
+/**
+ * @file OptimalSolver.cpp
+ * @brief Pattern database construction and the IDA* search
+ */
+
+#include "../include/OptimalSolver.hpp"
+#include "../include/Interleave.hpp"
+#include "../include/Symmetry.hpp"
+#include "../include/WorkStealing.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace {
+    /// Deepest bound the search will try (God's number is 20)
+    constexpr int kMaxDepth = 20;
+
+    /// Nodes between two reads of the clock
+    constexpr uint64_t kClockInterval = 1 << 16;
+
+    /// Nodes between two checks of the shared stop flags
+    constexpr uint64_t kCheckInterval = 1 << 10;
+
+    /// Depth at which a parallel search splits the tree into tasks (about 3,000 subtrees)
+    constexpr int kSplitDepth = 3;
+
+    /**
+     * @brief Ranks an ordered placement of 6 distinct slots out of 12
+     *
+     * Each slot is replaced by its index among the slots not used so far,
+     * giving mixed-radix digits of base 12, 11, ..., 7.
+     */
+    uint32_t placementRank(const std::array<uint8_t, 6>& slots) {
+        uint32_t rank = 0;
+        unsigned used = 0;
+        for (int i = 0; i < 6; ++i) {
+            const unsigned below = used & ((1u << slots[i]) - 1);
+            rank = rank * (12 - i) + (slots[i] - std::popcount(below));
+            used |= 1u << slots[i];
+        }
+        return rank;
+    }
+
+    /**
+     * @brief Inverse of placementRank
+     */
+    std::array<uint8_t, 6> placementUnrank(uint32_t rank) {
+        std::array<uint8_t, 6> digits{};
+        for (int i = 5; i >= 0; --i) {
+            digits[i] = (uint8_t)(rank % (12 - i));
+            rank /= (12 - i);
+        }
+        std::array<uint8_t, 6> slots{};
+        unsigned used = 0;
+        for (int i = 0; i < 6; ++i) {
+            // Pick the digits[i]-th free slot
+            int slot = 0;
+            for (int free = digits[i]; ; ++slot) {
+                if (used & (1u << slot)) continue;
+                if (free-- == 0) break;
+            }
+            slots[i] = (uint8_t)slot;
+            used |= 1u << slot;
+        }
+        return slots;
+    }
+
+    /**
+     * @brief Builds the shared placement move table of a six-edge group
+     */
+    TableStorage<uint32_t> buildEdgeMoveTable() {
+        // Destination slot of the piece in each slot, per move
+        std::array<std::array<uint8_t, 12>, kMoveCount> dest{};
+        for (size_t m = 0; m < kMoveCount; ++m) {
+            for (uint8_t i = 0; i < 12; ++i) dest[m][g_moveTables[m].edge_perm[i]] = i;
+        }
+
+        std::vector<uint32_t> table(kEdgeGroupPositions * kMoveCount);
+        for (uint32_t r = 0; r < kEdgeGroupPositions; ++r) {
+            const std::array<uint8_t, 6> slots = placementUnrank(r);
+            for (size_t m = 0; m < kMoveCount; ++m) {
+                std::array<uint8_t, 6> moved{};
+                uint32_t flips = 0;
+                for (int k = 0; k < 6; ++k) {
+                    moved[k] = dest[m][slots[k]];
+                    flips |= (uint32_t)g_moveTables[m].edge_ori_delta[moved[k]] << k;
+                }
+                table[r * kMoveCount + m] = (placementRank(moved) << 6) | flips;
+            }
+        }
+        return TableStorage<uint32_t>(std::move(table));
+    }
+
+    /**
+     * @brief Builds the pattern database of one six-edge group
+     */
+    PruningTable buildEdgeDatabase(const OptimalTables& t, int firstPiece, const TableBuildOptions& options) {
+        return PruningTable::build(kEdgeGroupCount, OptimalTables::edgeIndex(CubeState::solved(), firstPiece),
+                                   [&](size_t index, auto&& visit) {
+                                       for (size_t m = 0; m < kMoveCount; ++m) {
+                                           visit(t.moveEdges((uint32_t)index, m));
+                                       }
+                                   }, options);
+    }
+}
+
+OptimalTables::OptimalTables(const TableBuildOptions& options)
+    : cornerPerm(CoordMoveTable::build(kCornerPermCount, cornerPermCoord, g_allMoves)),
+      twist(CoordMoveTable::build(kTwistCount, twistCoord, g_allMoves)),
+      edgeMove(buildEdgeMoveTable()),
+      corners(PruningTable::build(cornerPerm, twist, g_allMoves, options).packed(options.encoding)),
+      edgesLow(buildEdgeDatabase(*this, 0, options).packed(options.encoding)),
+      edgesHigh(buildEdgeDatabase(*this, 6, options).packed(options.encoding)) {}
+
+namespace {
+    PruningEncoding fileEncoding(const TableFile& file) {
+        const uint8_t encoding = file.section<uint8_t>(6, 1)[0];
+        if (encoding > (uint8_t)PruningEncoding::Mod3) throw TableFileError("Unknown pruning table encoding");
+        return (PruningEncoding)encoding;
+    }
+
+    PruningTable fileDatabase(const TableFile& file, size_t index, size_t entries) {
+        const PruningEncoding encoding = fileEncoding(file);
+        return PruningTable(file.section<uint8_t>(index, PruningTable::packedBytes(entries, encoding)), entries, encoding);
+    }
+}
+
+OptimalTables::OptimalTables(const std::shared_ptr<const TableFile>& file)
+    : cornerPerm(file->section<uint16_t>(0, kCornerPermCount * kMoveCount)),
+      twist(file->section<uint16_t>(1, kTwistCount * kMoveCount)),
+      edgeMove(file->section<uint32_t>(2, kEdgeGroupPositions * kMoveCount)),
+      corners(fileDatabase(*file, 3, kCornerPatternCount)),
+      edgesLow(fileDatabase(*file, 4, kEdgeGroupCount)),
+      edgesHigh(fileDatabase(*file, 5, kEdgeGroupCount)) {}
+
+const OptimalTables& OptimalTables::instance() {
+    static const OptimalTables tables =
+        loadOrBuildTables<OptimalTables>(tableFilePath("optimal.tables"), TableBuildOptions{});
+    return tables;
+}
+
+void OptimalTables::save(const std::string& path) const {
+    TableFileWriter out(kFileKind);
+    out.add(cornerPerm.storage());
+    out.add(twist.storage());
+    out.add(edgeMove);
+    out.add(corners.storage());
+    out.add(edgesLow.storage());
+    out.add(edgesHigh.storage());
+    const TableStorage<uint8_t> encoding(std::vector<uint8_t>{(uint8_t)corners.encoding()});
+    out.add(encoding);
+    out.commit(path);
+}
+
+size_t OptimalTables::bytes() const {
+    return cornerPerm.bytes() + twist.bytes() + edgeMove.bytes() +
+           corners.bytes() + edgesLow.bytes() + edgesHigh.bytes();
+}
+
+uint32_t OptimalTables::edgeIndex(const CubeState& state, int firstPiece) {
+    std::array<uint8_t, 6> slots{};
+    uint32_t flips = 0;
+    for (int i = 0; i < 12; ++i) {
+        const int k = state.edgePiece(i) - firstPiece;
+        if (k < 0 || k >= 6) continue;
+        slots[k] = (uint8_t)i;
+        flips |= (uint32_t)state.edgeOrientation(i) << k;
+    }
+    return (placementRank(slots) << 6) | flips;
+}
+
+namespace {
+    /// Edge indices tracked per node: both groups of the state and of its two URF conjugates
+    constexpr int kEdgeProbes = 6;
+
+    /**
+     * @brief Database indices of one search node
+     *
+     * Conjugating a state by a whole-cube rotation preserves its distance,
+     * so the edge databases can also be probed on the state seen along the
+     * other two axes. Those probes cover different edge groups of the
+     * original cube and often give a larger bound.
+     */
+    struct Node {
+        uint16_t cornerPerm;
+        uint16_t twist;
+        std::array<uint32_t, kEdgeProbes> edges; ///< Low/high group of X, then of its two conjugates
+        std::array<uint8_t, 1 + kEdgeProbes> dist; ///< Exact database distances: corners, then each edge probe
+    };
+
+    /**
+     * @brief Maps a move on the state to the move on each tracked conjugate
+     */
+    constexpr std::array<std::array<uint8_t, kMoveCount>, kEdgeProbes> buildProbeMoves() {
+        std::array<std::array<uint8_t, kMoveCount>, kEdgeProbes> table{};
+        for (size_t m = 0; m < kMoveCount; ++m) {
+            table[0][m] = table[1][m] = (uint8_t)m;
+            table[2][m] = table[3][m] = g_urfConjugateMove[m];
+            table[4][m] = table[5][m] = g_urfInverseConjugateMove[m];
+        }
+        return table;
+    }
+
+    constexpr std::array<std::array<uint8_t, kMoveCount>, kEdgeProbes> g_probeMoves = buildProbeMoves();
+
+    bool cancelRequested(const SearchLimits& limits) {
+        return limits.cancel && limits.cancel->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Coordination between the workers of one parallel solve
+     *
+     * In fast mode the first solution found stops every worker. In
+     * deterministic mode a solution found in task i only stops tasks after
+     * i; the solution kept is the one of the lowest task, which is the one
+     * a serial search would have found first.
+     */
+    struct SharedSearch {
+        const bool deterministic;
+        std::atomic<bool> stop{false};                 ///< Set on timeout, or on any solution in fast mode
+        std::atomic<size_t> bestTask{SIZE_MAX};        ///< Lowest task with a solution (deterministic mode)
+        std::mutex lock;                               ///< Guards solution
+        std::vector<uint8_t> solution;                 ///< Moves of the kept solution
+
+        explicit SharedSearch(bool deterministic) : deterministic(deterministic) {}
+
+        bool cancels(size_t task) const {
+            return this->stop.load(std::memory_order_relaxed) ||
+                   (this->deterministic && this->bestTask.load(std::memory_order_relaxed) < task);
+        }
+
+        void offer(size_t task, const uint8_t* moves, int length) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if (this->deterministic) {
+                if (task >= this->bestTask.load(std::memory_order_relaxed)) return;
+                this->bestTask.store(task, std::memory_order_relaxed);
+            } else {
+                if (this->stop.exchange(true, std::memory_order_relaxed)) return;
+            }
+            this->solution.assign(moves, moves + length);
+        }
+    };
+
+    /**
+     * @brief Hashes a node and the face of the move that reached it into a transposition key
+     *
+     * The corner coordinates and the two edge groups of the unconjugated
+     * state identify the state. The face matters too: a subtree searched
+     * after a move on face f never starts with another move on f, so its
+     * bound only holds for visits that arrive the same way.
+     */
+    uint64_t transpositionKey(const Node& n, int prevFace) {
+        const uint64_t edges = ((uint64_t)n.edges[0] << 32) | n.edges[1];
+        const uint64_t corners = ((uint64_t)n.cornerPerm << 24) | ((uint64_t)n.twist << 8) | (uint8_t)prevFace;
+        // splitmix64 finalizer over both words
+        uint64_t x = edges ^ (corners * 0x9E3779B97F4A7C15ull);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Depth-first search state of one worker
+     */
+    class OptimalSearch {
+        const OptimalTables& t;
+        const SearchLimits& limits;
+        SharedSearch* shared;   ///< Null for a serial solve
+        TranspositionTable* tt; ///< Null without a transposition table
+
+    public:
+        std::array<uint8_t, kMaxDepth> path{};
+        int solutionLength = -1;
+        uint64_t nodes = 0;
+        TranspositionCounters transpositions; ///< Probes since construction, for TranspositionTable::record
+        bool timedOut = false;
+        bool cancelled = false;
+        size_t task = 0;        ///< Task being searched, for deterministic cancellation
+
+    private:
+        uint64_t nextCheck = kCheckInterval;
+        uint64_t nextClockCheck = kClockInterval;
+
+    public:
+        OptimalSearch(const OptimalTables& tables, const SearchLimits& limits, SharedSearch* shared = nullptr,
+                      TranspositionTable* transpositions = nullptr)
+            : t(tables), limits(limits), shared(shared), tt(transpositions) {}
+
+        Node rootNode(const CubeState& root) const {
+            const CubeState views[3] = {
+                root, conjugate(root, g_urfRotation), conjugate(root, inverseMove(g_urfRotation))
+            };
+            Node node{cornerPermCoord(root), twistCoord(root), {}, {}};
+            node.dist[0] = (uint8_t)t.corners.exactDistance(
+                (size_t)node.cornerPerm * kTwistCount + node.twist, [&](size_t index, auto&& visit) {
+                    for (size_t m = 0; m < kMoveCount; ++m) {
+                        visit((size_t)t.cornerPerm(index / kTwistCount, m) * kTwistCount + t.twist(index % kTwistCount, m));
+                    }
+                });
+            for (int k = 0; k < kEdgeProbes; ++k) {
+                node.edges[k] = OptimalTables::edgeIndex(views[k / 2], k % 2 == 0 ? 0 : 6);
+                node.dist[1 + k] = (uint8_t)edgeTable(k).exactDistance(node.edges[k], [&](size_t index, auto&& visit) {
+                    for (size_t m = 0; m < kMoveCount; ++m) visit(t.moveEdges((uint32_t)index, m));
+                });
+            }
+            return node;
+        }
+
+        int heuristic(const Node& n) const {
+            return *std::max_element(n.dist.begin(), n.dist.end());
+        }
+
+        /**
+         * @brief Computes the database indices of the child of @p n reached by move @p m
+         *
+         * Only move tables are read; the distances are filled in by probe().
+         */
+        void successor(const Node& n, size_t m, Node& c) const {
+            c.cornerPerm = t.cornerPerm(n.cornerPerm, m);
+            c.twist = t.twist(n.twist, m);
+            for (int k = 0; k < kEdgeProbes; ++k) c.edges[k] = t.moveEdges(n.edges[k], g_probeMoves[k][m]);
+        }
+
+        /**
+         * @brief Starts loading every database entry of @p c
+         */
+        void prefetch(const Node& c) const {
+            t.corners.prefetch((size_t)c.cornerPerm * kTwistCount + c.twist);
+            for (int k = 0; k < kEdgeProbes; ++k) edgeTable(k).prefetch(c.edges[k]);
+        }
+
+        /**
+         * @brief Reads the distances of child @p c of @p n, unless it is pruned
+         * @param slack Largest heuristic the child may have
+         * @param h Receives the child's heuristic; for a pruned child, a lower
+         *          bound on it above @p slack
+         * @return false if some database proves the child exceeds the bound
+         *
+         * Databases are probed one at a time so that, without prefetching, a
+         * pruned child costs as few cache misses as possible.
+         */
+        bool probe(const Node& n, Node& c, int slack, int& h) const {
+            h = t.corners.distance((size_t)c.cornerPerm * kTwistCount + c.twist, n.dist[0]);
+            if (h > slack) return false;
+            c.dist[0] = (uint8_t)h;
+            for (int k = 0; k < kEdgeProbes; ++k) {
+                const int he = edgeTable(k).distance(c.edges[k], n.dist[k + 1]);
+                if (he > slack) {
+                    h = std::max(h, he);
+                    return false;
+                }
+                c.dist[k + 1] = (uint8_t)he;
+                h = std::max(h, he);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Computes and prefetches every child of @p n that may follow @p prevFace
+         * @return The number of children, stored with their moves in order
+         */
+        int expand(const Node& n, int prevFace, std::array<Node, kMoveCount>& children,
+                   std::array<uint8_t, kMoveCount>& moves) const {
+            int count = 0;
+            for (size_t m = 0; m < kMoveCount; ++m) {
+                if (!canFollow((int)m / 3, prevFace)) continue;
+                successor(n, m, children[count]);
+                prefetch(children[count]);
+                moves[count++] = (uint8_t)m;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Computes the child of @p n reached by move @p m, unless it is pruned
+         */
+        bool child(const Node& n, size_t m, int slack, Node& c, int& h) const {
+            successor(n, m, c);
+            return probe(n, c, slack, h);
+        }
+
+        /**
+         * @brief Counts a node and reports whether the search must stop
+         */
+        bool mustStop() {
+            if (++this->nodes < this->nextCheck) return false;
+            this->nextCheck = this->nodes + kCheckInterval;
+            if (this->shared && this->shared->cancels(this->task)) this->cancelled = true;
+            if (cancelRequested(this->limits)) {
+                this->cancelled = true;
+                if (this->shared) this->shared->stop.store(true, std::memory_order_relaxed);
+            }
+            if (this->nodes >= this->nextClockCheck) {
+                this->nextClockCheck = this->nodes + kClockInterval;
+                if (std::chrono::steady_clock::now() >= this->limits.deadline) {
+                    this->timedOut = true;
+                    if (this->shared) this->shared->stop.store(true, std::memory_order_relaxed);
+                }
+            }
+            return this->cancelled || this->timedOut;
+        }
+
+        /**
+         * @brief Expands one node at depth @p g under cost bound @p bound
+         *
+         * A heuristic of 0 means every database is at its goal, which happens
+         * only for the solved cube, so no separate goal test is needed.
+         */
+        bool search(const Node& n, int g, int bound, int prevFace) {
+            int needed = 0;
+            return this->tt ? search<true>(n, g, bound, prevFace, needed)
+                            : search<false>(n, g, bound, prevFace, needed);
+        }
+
+        /**
+         * @brief As above, with the transposition table compiled in or out
+         * @param needed With the table, receives if the search fails a lower
+         *               bound on the length of any solution from @p n whose
+         *               first move may follow @p prevFace; more than bound - g
+         *
+         * The bound is the smallest of one plus each child's: its heuristic
+         * if pruned, its table bound if skipped, else its own backed-up
+         * bound. It is what the table stores, and unlike bound - g + 1 it can
+         * still prune in the next iteration.
+         */
+        template <bool kTranspositions>
+        bool search(const Node& n, int g, int bound, int prevFace, int& needed) {
+            if constexpr (kTranspositions) needed = UINT8_MAX; // Largest bound an entry holds
+#if RUBIKS_PREFETCH
+            // Every child's database entries are requested before any is read
+            std::array<Node, kMoveCount> children;
+            std::array<uint8_t, kMoveCount> moves;
+            const int count = expand(n, prevFace, children, moves);
+            for (int i = 0; i < count; ++i) {
+                const size_t m = moves[i];
+                Node& c = children[i];
+#else
+            for (size_t m = 0; m < kMoveCount; ++m) {
+                if (!canFollow((int)m / 3, prevFace)) continue;
+                Node c;
+                successor(n, m, c);
+#endif
+                if (mustStop()) return false;
+                int h = 0;
+                if (!probe(n, c, bound - g - 1, h)) {
+                    if constexpr (kTranspositions) needed = std::min(needed, h + 1);
+                    continue;
+                }
+
+                this->path[g] = (uint8_t)m;
+                if (h == 0) {
+                    this->solutionLength = g + 1;
+                    return true;
+                }
+                if constexpr (!kTranspositions) {
+                    if (search<false>(c, g + 1, bound, (int)m / 3, needed)) return true;
+                } else {
+                    const int remaining = bound - g - 1;
+                    const bool cached = remaining >= kTranspositionMinDepth;
+                    const uint64_t key = cached ? transpositionKey(c, (int)m / 3) : 0;
+                    int below = cached ? knownBound(key, remaining) : 0;
+                    if (below <= remaining) {
+                        if (search<true>(c, g + 1, bound, (int)m / 3, below)) return true;
+                        if (cached && !this->cancelled && !this->timedOut) {
+                            this->tt->store(key, below);
+                            ++this->transpositions.stores;
+                        }
+                    }
+                    needed = std::min(needed, below + 1);
+                }
+            }
+            return false;
+        }
+
+    private:
+        /**
+         * @brief Looks up the bound of @p key, counting the probe
+         * @return The stored bound, or 0; above @p remaining the child is skipped
+         */
+        int knownBound(uint64_t key, int remaining) {
+            const int known = this->tt->lowerBound(key);
+            if (known == 0) {
+                ++this->transpositions.misses;
+                return 0;
+            }
+            ++this->transpositions.hits;
+            if (known > remaining) ++this->transpositions.cutoffs;
+            return known;
+        }
+
+        const PruningTable& edgeTable(int probe) const {
+            return probe % 2 == 0 ? t.edgesLow : t.edgesHigh;
+        }
+    };
+
+    /**
+     * @brief A subtree root: the node reached by a fixed move prefix
+     */
+    struct Task {
+        Node node;
+        std::array<uint8_t, kSplitDepth> prefix;
+        int prevFace;
+    };
+
+    /**
+     * @brief Lists, in search order, every unpruned node at kSplitDepth under @p bound
+     */
+    void collectTasks(OptimalSearch& s, const Node& n, int g, int bound, int prevFace,
+                      std::array<uint8_t, kSplitDepth>& prefix, std::vector<Task>& out) {
+        if (g == kSplitDepth) {
+            out.push_back({n, prefix, prevFace});
+            return;
+        }
+        for (size_t m = 0; m < kMoveCount; ++m) {
+            const int face = (int)m / 3;
+            if (!canFollow(face, prevFace)) continue;
+            ++s.nodes;
+            Node c;
+            int h = 0;
+            if (!s.child(n, m, bound - g - 1, c, h)) continue;
+            prefix[g] = (uint8_t)m;
+            collectTasks(s, c, g + 1, bound, face, prefix, out);
+        }
+    }
+
+    SolveResult finish(std::chrono::steady_clock::time_point start, const uint8_t* moves, int length,
+                       uint64_t nodes, bool timedOut) {
+        SolveResult result;
+        result.solved = length >= 0;
+        result.timedOut = timedOut && !result.solved;
+        for (int i = 0; i < length; ++i) result.moves.push_back(static_cast<RubiksCube::Move>(moves[i]));
+        result.stats.nodes = nodes;
+        result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    SolveResult solveSerial(const CubeState& root, const SearchLimits& limits, const OptimalTables& t,
+                            TranspositionTable* transpositions) {
+        const auto start = std::chrono::steady_clock::now();
+        OptimalSearch s(t, limits, nullptr, transpositions);
+        const Node node = s.rootNode(root);
+        const int h = s.heuristic(node);
+        if (h == 0) {
+            s.solutionLength = 0;
+        } else {
+            for (int bound = h; bound <= limits.maxLength && !s.timedOut && !s.cancelled; ++bound) {
+                if (s.search(node, 0, bound, kNoFace)) break;
+            }
+        }
+        if (transpositions) transpositions->record(s.transpositions);
+        return finish(start, s.path.data(), s.solutionLength, s.nodes, s.timedOut);
+    }
+
+    /**
+     * @brief Runs each IDA* iteration as subtree tasks on a work-stealing scheduler
+     *
+     * Iterations with a bound of at most kSplitDepth are cheap and run
+     * serially; a solution there is found before any split is needed.
+     */
+    SolveResult solveParallel(const CubeState& root, const SearchLimits& limits, const OptimalTables& t,
+                              const OptimalOptions& options) {
+        const auto start = std::chrono::steady_clock::now();
+        OptimalSearch main(t, limits, nullptr, options.transpositions);
+        const Node node = main.rootNode(root);
+        const int h = main.heuristic(node);
+        if (h == 0) return finish(start, nullptr, 0, 0, false);
+
+        // main.nodes keeps running across iterations so that mustStop() keeps
+        // checking the stop flags and clock on schedule; this counts the workers
+        uint64_t nodes = 0;
+        bool timedOut = false;
+        for (int bound = h; bound <= limits.maxLength && !timedOut && !cancelRequested(limits); ++bound) {
+            if (bound <= kSplitDepth) {
+                const bool found = main.search(node, 0, bound, kNoFace);
+                timedOut = main.timedOut;
+                if (found) {
+                    if (options.transpositions) options.transpositions->record(main.transpositions);
+                    return finish(start, main.path.data(), main.solutionLength, main.nodes + nodes, false);
+                }
+                continue;
+            }
+
+            std::vector<Task> tasks;
+            std::array<uint8_t, kSplitDepth> prefix{};
+            collectTasks(main, node, 0, bound, kNoFace, prefix, tasks);
+
+            SharedSearch shared(options.deterministic);
+            std::vector<OptimalSearch> workers(options.threads, OptimalSearch(t, limits, &shared, options.transpositions));
+            runWorkStealing(tasks.size(), options.threads, [&](size_t i, unsigned w) {
+                OptimalSearch& s = workers[w];
+                if (shared.cancels(i)) return;
+                const Task& task = tasks[i];
+                s.task = i;
+                s.cancelled = false;
+                std::copy(task.prefix.begin(), task.prefix.end(), s.path.begin());
+                if (s.search(task.node, kSplitDepth, bound, task.prevFace)) {
+                    shared.offer(i, s.path.data(), s.solutionLength);
+                }
+            });
+            for (const OptimalSearch& s : workers) {
+                nodes += s.nodes;
+                timedOut = timedOut || s.timedOut;
+                if (options.transpositions) options.transpositions->record(s.transpositions);
+            }
+            if (!shared.solution.empty()) {
+                if (options.transpositions) options.transpositions->record(main.transpositions);
+                return finish(start, shared.solution.data(), (int)shared.solution.size(), main.nodes + nodes, false);
+            }
+        }
+        if (options.transpositions) options.transpositions->record(main.transpositions);
+        return finish(start, nullptr, -1, main.nodes + nodes, timedOut);
+    }
+
+    /**
+     * @brief One serial solve written as a coroutine that yields after every node expansion
+     * @param out Receives the result when the coroutine finishes
+     *
+     * The same IDA* as OptimalSearch::search, with the recursion replaced by
+     * an explicit stack of expanded nodes: each expansion computes and
+     * prefetches all children, then suspends so that the other solves on
+     * the thread run while the entries load. Solutions and node counts are
+     * those of solveSerial.
+     */
+    InterleavedTask interleavedSolve(const OptimalTables& t, CubeState root, SearchLimits limits,
+                                     std::chrono::milliseconds timeout, SolveResult& out) {
+        const auto start = std::chrono::steady_clock::now();
+        if (timeout.count() > 0) limits.deadline = std::min(limits.deadline, start + timeout);
+        OptimalSearch s(t, limits);
+        const Node node = s.rootNode(root);
+        const int h = s.heuristic(node);
+
+        struct Frame {
+            Node parent;
+            int count;   ///< Children expanded
+            int next;    ///< Next child to probe
+            std::array<Node, kMoveCount> children;
+            std::array<uint8_t, kMoveCount> moves;
+        };
+        std::vector<Frame> stack(kMaxDepth + 1);
+
+        if (h == 0) s.solutionLength = 0;
+        for (int bound = h; h > 0 && bound <= limits.maxLength && s.solutionLength < 0; ++bound) {
+            stack[0].parent = node;
+            stack[0].count = s.expand(node, kNoFace, stack[0].children, stack[0].moves);
+            stack[0].next = 0;
+            co_await YieldToOthers{};
+            for (int g = 0; g >= 0; ) {
+                Frame& f = stack[g];
+                if (f.next == f.count) {
+                    --g;
+                    continue;
+                }
+                const int i = f.next++;
+                if (s.mustStop()) break;
+                int hc = 0;
+                if (!s.probe(f.parent, f.children[i], bound - g - 1, hc)) continue;
+
+                s.path[g] = f.moves[i];
+                if (hc == 0) {
+                    s.solutionLength = g + 1;
+                    break;
+                }
+                Frame& down = stack[++g];
+                down.parent = f.children[i];
+                down.count = s.expand(down.parent, f.moves[i] / 3, down.children, down.moves);
+                down.next = 0;
+                co_await YieldToOthers{};
+            }
+            if (s.timedOut || s.cancelled) break;
+        }
+        out = finish(start, s.path.data(), s.solutionLength, s.nodes, s.timedOut);
+    }
+}
+
+SolveResult solveOptimal(const CubeState& state, const SearchLimits& limits, const OptimalOptions& options,
+                         const OptimalTables& tables) {
+    SearchLimits bounded = limits;
+    bounded.maxLength = std::clamp(limits.maxLength, 0, kMaxDepth);
+    OptimalOptions resolved = options;
+    if (resolved.threads == 0) resolved.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (resolved.threads == 1) return solveSerial(state, bounded, tables, resolved.transpositions);
+    return solveParallel(state, bounded, tables, resolved);
+}
+
+std::vector<SolveResult> solveOptimalBatch(std::span<const CubeState> states, const SearchLimits& limits,
+                                           const OptimalBatchOptions& options, const OptimalTables& tables) {
+    SearchLimits bounded = limits;
+    bounded.maxLength = std::clamp(limits.maxLength, 0, kMaxDepth);
+    const unsigned threads = options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+    std::vector<SolveResult> results(states.size());
+    runInterleaved(states.size(), threads, options.interleave, [&](size_t i) {
+        return interleavedSolve(tables, states[i], bounded, options.timeout, results[i]);
+    });
+    return results;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file PackedCube.cpp
+ * @brief Conversions between PackedCube and RubiksCube
+ *
+ * Move application is inlined in the header so it can stay in registers
+ * inside tight loops; this file only holds the non-hot-path members.
+ */
+
+#include "../include/PackedCube.hpp"
+
+PackedCube::PackedCube() {
+    reset();
+}
+
+void PackedCube::reset() {
+    // Slot i holds piece i with orientation 0; padding bytes hold their own
+    // index so that the identity shuffle entries keep them constant.
+    for (uint8_t i = 0; i < 16; ++i) {
+        this->bytes[i] = i;
+        this->bytes[16 + i] = i;
+    }
+}
+
+bool PackedCube::isSolved() const {
+    return *this == PackedCube();
+}
+
+PackedCube PackedCube::fromCube(const RubiksCube& cube) {
+    PackedCube packed;
+    for (int i = 0; i < 8; ++i) {
+        packed.bytes[i] = (uint8_t)(cube.cornerPiece(i) | (cube.cornerOrientation(i) << 4));
+    }
+    for (int i = 0; i < 12; ++i) {
+        packed.bytes[16 + i] = (uint8_t)(cube.edgePiece(i) | (cube.edgeOrientation(i) << 4));
+    }
+    return packed;
+}
+
+RubiksCube PackedCube::toCube() const {
+    RubiksCube cube;
+    for (int i = 0; i < 8; ++i) {
+        cube.setCorner(i, this->bytes[i] & 0x0F, this->bytes[i] >> 4);
+    }
+    for (int i = 0; i < 12; ++i) {
+        cube.setEdge(i, this->bytes[16 + i] & 0x0F, this->bytes[16 + i] >> 4);
+    }
+    return cube;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file PruningTable.cpp
+ * @brief Construction helpers for distance tables
+ */
+
+#include "../include/PruningTable.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    /// Entries scanned per block handed to a thread
+    constexpr size_t kBlockSize = 1 << 16;
+}
+
+unsigned tableBuildThreads(size_t size, unsigned requested) {
+    if (requested == 0) requested = std::max(1u, std::thread::hardware_concurrency());
+    // Small tables build in microseconds; starting threads would cost more
+    return (unsigned)std::min<size_t>(requested, std::max<size_t>(1, size / (4 * kBlockSize)));
+}
+
+size_t parallelBlockSum(size_t size, unsigned threads, const std::function<size_t(size_t begin, size_t end)>& scan) {
+    if (threads <= 1) {
+        size_t total = 0;
+        for (size_t begin = 0; begin < size; begin += kBlockSize) total += scan(begin, std::min(size, begin + kBlockSize));
+        return total;
+    }
+
+    std::atomic<size_t> nextBlock{0};
+    std::atomic<size_t> total{0};
+    auto work = [&] {
+        size_t sum = 0;
+        for (size_t begin; (begin = nextBlock.fetch_add(kBlockSize, std::memory_order_relaxed)) < size;) {
+            sum += scan(begin, std::min(size, begin + kBlockSize));
+        }
+        total.fetch_add(sum, std::memory_order_relaxed);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (std::thread& w : workers) w.join();
+    return total.load();
+}
+
+PruningTable PruningTable::build(const CoordMoveTable& a, const CoordMoveTable& b,
+                                 std::span<const RubiksCube::Move> moves, const TableBuildOptions& options) {
+    const size_t sizeB = b.size();
+    return build(a.size() * sizeB, 0, [&](size_t index, auto&& visit) {
+        const size_t x = index / sizeB;
+        const size_t y = index % sizeB;
+        for (RubiksCube::Move m : moves) {
+            visit((size_t)a(x, m) * sizeB + b(y, m));
+        }
+    }, options);
+}
+
+PruningTable::PruningTable(TableStorage<uint8_t> dist, size_t entries, PruningEncoding encoding)
+    : dist(std::move(dist)), entries(entries), packing(encoding) {
+    switch (encoding) {
+        case PruningEncoding::Byte: this->perByteLog2 = 0; this->bitsLog2 = 3; this->valueMask = 0xFF; break;
+        case PruningEncoding::Nibble: this->perByteLog2 = 1; this->bitsLog2 = 2; this->valueMask = 0x0F; break;
+        case PruningEncoding::Mod3: this->perByteLog2 = 2; this->bitsLog2 = 1; this->valueMask = 0x03; break;
+    }
+}
+
+size_t PruningTable::packedBytes(size_t entries, PruningEncoding encoding) {
+    switch (encoding) {
+        case PruningEncoding::Nibble: return (entries + 1) / 2;
+        case PruningEncoding::Mod3: return (entries + 3) / 4;
+        default: return entries;
+    }
+}
+
+PruningTable PruningTable::packed(PruningEncoding encoding) const {
+    if (this->packing != PruningEncoding::Byte) throw std::logic_error("Only byte tables can be repacked");
+    if (encoding == PruningEncoding::Byte) return *this;
+
+    const PruningTable layout(TableStorage<uint8_t>(), this->entries, encoding);
+    std::vector<uint8_t> out(packedBytes(this->entries, encoding), 0);
+    for (size_t i = 0; i < this->entries; ++i) {
+        const uint8_t d = this->dist[i];
+        uint8_t value = 0;
+        if (encoding == PruningEncoding::Nibble) {
+            if (d > 14 && d != kUnreached) throw std::logic_error("Distance too large for a nibble table");
+            value = d == kUnreached ? 0x0F : d;
+        } else {
+            if (d == kUnreached) throw std::logic_error("Mod-3 tables cannot hold unreached entries");
+            value = d % 3;
+        }
+        const unsigned shift = (unsigned)(i & ((1u << layout.perByteLog2) - 1)) << layout.bitsLog2;
+        out[i >> layout.perByteLog2] |= (uint8_t)(value << shift);
+    }
+    return PruningTable(TableStorage<uint8_t>(std::move(out)), this->entries, encoding);
+}
+
+uint8_t PruningTable::maxDistance() const {
+    uint8_t best = 0;
+    for (size_t i = 0; i < this->entries; ++i) {
+        const uint8_t d = (*this)[i];
+        if (d != kUnreached && d != this->valueMask) best = std::max(best, d);
+    }
+    return best;
+}
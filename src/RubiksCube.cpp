@@ -9,25 +9,27 @@
  * - Uses piece-based representation with corner and edge pieces
  * - Move tables define permutations and orientation changes for each face turn
  * - Supports standard Singmaster notation with automatic derivation of inverse/double moves
- * - Thread-safe move table initialization using static local variables
+ * - Move tables are constant-initialized at compile time (see MoveTables.hpp), so
+ *   the move path needs no initialization step or synchronization across threads
  */
 
 #include "../include/RubiksCube.hpp"
-#include <iostream>
-#include <unordered_map>
+#include "../include/MoveTables.hpp"
+#include "../include/CompiledSequence.hpp"
+#include "../include/MoveSequence.hpp"
+#include "../include/Facelets.hpp"
+#include "../include/ScrambleGenerator.hpp"
+#include <algorithm>
+#include <stdexcept>
 #include <string>
-#include <vector>
 #include <random>
 #include <sstream>
+#include <type_traits>
 
 RubiksCube::RubiksCube() {
     reset();
 }
 
-RubiksCube::~RubiksCube() {
-    std::cout << "RubiksCube destructor" << std::endl;
-}
-
 void RubiksCube::reset() {
     // Initialize each slot with the matching piece index and orientation 0.
     // In the solved state, slot i contains piece i with zero orientation.
@@ -53,156 +55,159 @@ bool RubiksCube::isSolved() const {
     return true;
 }
 
-namespace {
-    /**
-     * @brief Defines a move in terms of piece permutations and orientation changes
-     * 
-     * Each move is represented by how pieces are permuted and how their orientations
-     * change. For corners, orientation ranges 0-2; for edges, 0-1.
-     */
-    struct MoveDef {
-        std::array<int, 8> corner_perm;      ///< Where each corner slot gets its piece from
-        std::array<int, 8> corner_ori_delta; ///< Orientation change for each corner (0-2)
-        std::array<int, 12> edge_perm;       ///< Where each edge slot gets its piece from  
-        std::array<int, 12> edge_ori_delta;  ///< Orientation change for each edge (0-1)
-    };
+bool RubiksCube::operator==(const RubiksCube& other) const {
+    for (int i = 0; i < 8; ++i) {
+        if (this->corners[i].index != other.corners[i].index ||
+            this->corners[i].orientation != other.corners[i].orientation) return false;
+    }
+    for (int i = 0; i < 12; ++i) {
+        if (this->edges[i].index != other.edges[i].index ||
+            this->edges[i].orientation != other.edges[i].orientation) return false;
+    }
+    return true;
+}
 
-    /// Global move table mapping move names to their definitions
-    std::unordered_map<std::string, MoveDef> g_moveTables;
+RubiksCube RubiksCube::compose(const RubiksCube& a, const RubiksCube& b) {
+    // b says which slot each piece is pulled from; the piece found there in a
+    // moves along, accumulating b's orientation change on top of a's.
+    RubiksCube r;
+    for (int i = 0; i < 8; ++i) {
+        const CornerPiece& from = a.corners[b.corners[i].index];
+        r.corners[i].index = from.index;
+        r.corners[i].orientation = (uint8_t)((from.orientation + b.corners[i].orientation) % 3);
+    }
+    for (int i = 0; i < 12; ++i) {
+        const EdgePiece& from = a.edges[b.edges[i].index];
+        r.edges[i].index = from.index;
+        r.edges[i].orientation = (uint8_t)((from.orientation + b.edges[i].orientation) % 2);
+    }
+    return r;
+}
 
+RubiksCube RubiksCube::inverse() const {
+    // If slot i holds piece p twisted by o, the inverse pulls piece i into
+    // slot p and undoes the twist.
+    RubiksCube r;
+    for (uint8_t i = 0; i < 8; ++i) {
+        r.corners[this->corners[i].index].index = i;
+        r.corners[this->corners[i].index].orientation = (uint8_t)((3 - this->corners[i].orientation) % 3);
+    }
+    for (uint8_t i = 0; i < 12; ++i) {
+        r.edges[this->edges[i].index].index = i;
+        r.edges[this->edges[i].index].orientation = this->edges[i].orientation;
+    }
+    return r;
+}
+
+RubiksCube RubiksCube::pow(int k) const {
+    RubiksCube base = k < 0 ? inverse() : *this;
+    // Widen before negating so INT_MIN is handled
+    long long e = k < 0 ? -(long long)k : k;
+    RubiksCube result;
+    while (e > 0) {
+        if (e & 1) result = compose(result, base);
+        base = compose(base, base);
+        e >>= 1;
+    }
+    return result;
+}
+
+uint8_t RubiksCube::cornerPiece(int slot) const {
+    return this->corners[slot].index;
+}
+
+uint8_t RubiksCube::cornerOrientation(int slot) const {
+    return this->corners[slot].orientation;
+}
+
+uint8_t RubiksCube::edgePiece(int slot) const {
+    return this->edges[slot].index;
+}
+
+uint8_t RubiksCube::edgeOrientation(int slot) const {
+    return this->edges[slot].orientation;
+}
+
+void RubiksCube::setCorner(int slot, uint8_t piece, uint8_t orientation) {
+    this->corners[slot].index = piece;
+    this->corners[slot].orientation = orientation;
+}
+
+void RubiksCube::setEdge(int slot, uint8_t piece, uint8_t orientation) {
+    this->edges[slot].index = piece;
+    this->edges[slot].orientation = orientation;
+}
+
+namespace {
     /**
-     * @brief Initializes the move tables with all 18 possible moves
-     * 
-     * Creates move definitions for:
-     * - 6 base moves (U, D, R, L, F, B) - clockwise quarter turns
-     * - 6 inverse moves (U', D', R', L', F', B') - counter-clockwise
-     * - 6 double moves (U2, D2, R2, L2, F2, B2) - 180-degree turns
+     * @brief Checks the invariants every derived move must satisfy
      * 
-     * Base moves are defined manually, inverse and double moves are derived
-     * by applying the base move multiple times to track the resulting permutation.
+     * Each quarter turn has order four, its prime is its inverse and its double
+     * is self-inverse. Every move twists corners by a multiple of three and flips
+     * an even number of edges, so orientation sums are preserved.
      */
-    void initMoveTablesOnce() {
-        if (!g_moveTables.empty()) return;
-
-        std::array<int, 8> c_zero{};   // All zeros for corner orientations
-        std::array<int, 12> e_zero{};  // All zeros for edge orientations
-
-        // Base quarter-turn moves (clockwise when viewing the face)
-        // Each array shows where slot i gets its piece from
-        
-        // U (Up) face: rotates top layer clockwise
-        g_moveTables["U"] = MoveDef{
-            {3,0,1,2,4,5,6,7}, c_zero,
-            {3,0,1,2,4,5,6,7,8,9,10,11}, e_zero
-        };
-        
-        // D (Down) face: rotates bottom layer clockwise  
-        g_moveTables["D"] = MoveDef{
-            {0,1,2,3,5,6,7,4}, c_zero,
-            {0,1,2,3,5,6,7,4,8,9,10,11}, e_zero
-        };
-        
-        // R (Right) face: rotates right layer clockwise
-        g_moveTables["R"] = MoveDef{
-            {0,1,2,3,5,6,7,4}, {0,0,0,0,2,1,2,1},
-            {0,9,2,3,4,5,6,7,8,11,10,1}, e_zero
-        };
-        
-        // L (Left) face: rotates left layer clockwise
-        g_moveTables["L"] = MoveDef{
-            {2,6,7,3,4,0,1,5}, {1,2,1,0,0,2,1,0},
-            {0,1,10,3,4,5,9,7,8,2,6,11}, e_zero
-        };
-        
-        // F (Front) face: rotates front layer clockwise
-        g_moveTables["F"] = MoveDef{
-            {1,5,2,3,0,4,6,7}, {1,2,0,0,2,1,0,0},
-            {0,8,2,3,4,9,6,7,5,1,10,11}, {0,1,0,0,0,1,0,0,1,1,0,0}
-        };
-        
-        // B (Back) face: rotates back layer clockwise
-        g_moveTables["B"] = MoveDef{
-            {0,1,3,7,4,5,2,6}, {0,0,1,2,0,0,2,1},
-            {0,1,2,11,4,5,6,10,8,9,3,7}, {0,0,0,1,0,0,0,1,0,0,1,1}
-        };
-
-        /**
-         * @brief Generate derived moves (inverse and double) from base moves
-         * 
-         * For each base move, we generate:
-         * - Double move (m2): Apply base move twice
-         * - Inverse move (m'): Apply base move three times (equivalent to one counter-clockwise)
-         * 
-         * This is done by simulating the moves on a temporary cube state and recording
-         * the resulting permutation and orientation changes.
-         */
-        const std::vector<std::string> baseMoves = {"U","D","R","L","F","B"};
-        for (const auto& m : baseMoves) {
-            // Set up temporary cube state for simulation
-            std::array<uint8_t, 8> corner_index{};
-            std::array<uint8_t, 8> corner_ori{};
-            std::array<uint8_t, 12> edge_index{};
-            std::array<uint8_t, 12> edge_ori{};
-            
-            // Initialize to solved state
-            for (int i = 0; i < 8; ++i) { corner_index[i] = (uint8_t)i; corner_ori[i] = 0; }
-            for (int i = 0; i < 12; ++i) { edge_index[i] = (uint8_t)i; edge_ori[i] = 0; }
-
-            // Lambda to apply a move definition to the temporary state
-            auto applyLocal = [&](const MoveDef& def) {
-                std::array<uint8_t, 8> new_c_idx{};
-                std::array<uint8_t, 8> new_c_ori{};
-                for (int i = 0; i < 8; ++i) {
-                    new_c_idx[i] = corner_index[def.corner_perm[i]];
-                    new_c_ori[i] = (uint8_t)((corner_ori[def.corner_perm[i]] + def.corner_ori_delta[i]) % 3);
-                }
-                corner_index = new_c_idx;
-                corner_ori = new_c_ori;
-
-                std::array<uint8_t, 12> new_e_idx{};
-                std::array<uint8_t, 12> new_e_ori{};
-                for (int i = 0; i < 12; ++i) {
-                    new_e_idx[i] = edge_index[def.edge_perm[i]];
-                    new_e_ori[i] = (uint8_t)((edge_ori[def.edge_perm[i]] + def.edge_ori_delta[i]) % 2);
-                }
-                edge_index = new_e_idx;
-                edge_ori = new_e_ori;
-            };
-
-            // Generate double move (m2): apply base move twice
-            applyLocal(g_moveTables[m]);
-            applyLocal(g_moveTables[m]);
-
-            MoveDef m2{};
-            for (int i = 0; i < 8; ++i) { m2.corner_perm[i] = corner_index[i]; m2.corner_ori_delta[i] = corner_ori[i]; }
-            for (int i = 0; i < 12; ++i) { m2.edge_perm[i] = edge_index[i]; m2.edge_ori_delta[i] = edge_ori[i]; }
-            g_moveTables[m + "2"] = m2;
-
-            // Generate inverse move (m'): apply base move three times
-            // Reset to solved state first
-            for (int i = 0; i < 8; ++i) { corner_index[i] = (uint8_t)i; corner_ori[i] = 0; }
-            for (int i = 0; i < 12; ++i) { edge_index[i] = (uint8_t)i; edge_ori[i] = 0; }
-            
-            applyLocal(g_moveTables[m]);
-            applyLocal(g_moveTables[m]);
-            applyLocal(g_moveTables[m]);
-            
-            MoveDef inv{};
-            for (int i = 0; i < 8; ++i) { inv.corner_perm[i] = corner_index[i]; inv.corner_ori_delta[i] = corner_ori[i]; }
-            for (int i = 0; i < 12; ++i) { inv.edge_perm[i] = edge_index[i]; inv.edge_ori_delta[i] = edge_ori[i]; }
-            g_moveTables[m + "'"] = inv;
+    constexpr bool moveTablesConsistent() {
+        const MoveDef id = identityMove();
+        for (int f = 0; f < 6; ++f) {
+            const MoveDef& q = g_moveTables[3 * f];
+            const MoveDef& p = g_moveTables[3 * f + 1];
+            const MoveDef& d = g_moveTables[3 * f + 2];
+            if (!sameMove(composeMoves(q, p), id)) return false;
+            if (!sameMove(composeMoves(p, q), id)) return false;
+            if (!sameMove(composeMoves(d, d), id)) return false;
+            if (!sameMove(composeMoves(composeMoves(q, q), composeMoves(q, q)), id)) return false;
         }
+        for (const MoveDef& m : g_moveTables) {
+            int twist = 0, flip = 0;
+            for (int i = 0; i < 8; ++i) twist += m.corner_ori_delta[i];
+            for (int i = 0; i < 12; ++i) flip += m.edge_ori_delta[i];
+            if (twist % 3 != 0 || flip % 2 != 0) return false;
+        }
+        return true;
     }
+
+    static_assert(moveTablesConsistent(), "move tables do not describe a valid cube");
+
+    // Cubes are copied freely by value; keep the copy a plain memcpy
+    static_assert(std::is_trivially_copyable_v<RubiksCube>, "RubiksCube must stay trivially copyable");
 }
 
-void RubiksCube::applyMove(const std::string& move) {
-    initMoveTablesOnce();
-    auto it = g_moveTables.find(move);
-    if (it == g_moveTables.end()) {
-        throw std::invalid_argument("Invalid move: " + move);
+RubiksCube::Move RubiksCube::parseMove(const std::string& token) {
+    static constexpr char faces[] = "UDRLFB";
+    if (token.empty() || token.size() > 2) {
+        throw std::invalid_argument("Invalid move: " + token);
+    }
+    int face = 0;
+    while (face < 6 && faces[face] != token[0]) ++face;
+    if (face == 6) {
+        throw std::invalid_argument("Invalid move: " + token);
+    }
+    int variant = 0;  // 0 = clockwise, 1 = prime, 2 = double
+    if (token.size() == 2) {
+        if (token[1] == '\'') variant = 1;
+        else if (token[1] == '2') variant = 2;
+        else throw std::invalid_argument("Invalid move: " + token);
     }
-    const MoveDef& def = it->second;
+    return static_cast<Move>(3 * face + variant);
+}
+
+const char* RubiksCube::moveName(Move move) {
+    return g_moveNames[static_cast<size_t>(move)];
+}
+
+void RubiksCube::applyMove(const std::string& move) {
+    applyMove(parseMove(move));
+}
+
+void RubiksCube::applyMove(RubiksCube::Move move) {
+    applyDefinition(moveDefinition(move));
+}
 
+void RubiksCube::applySequence(const CompiledSequence& sequence) {
+    applyDefinition(sequence.definition());
+}
+
+void RubiksCube::applyDefinition(const MoveDef& def) {
     // Apply corner permutation and orientation changes
     // For each slot i, get the piece from slot def.corner_perm[i] and add orientation delta
     std::array<CornerPiece, 8> newCorners{};
@@ -224,69 +229,39 @@ void RubiksCube::applyMove(const std::string& move) {
     this->edges = newEdges;
 }
 
-static std::string moveEnumToString(RubiksCube::Move move) {
-    switch (move) {
-        case RubiksCube::Move::U: return "U";
-        case RubiksCube::Move::U_PRIME: return "U'";
-        case RubiksCube::Move::U2: return "U2";
-        case RubiksCube::Move::D: return "D";
-        case RubiksCube::Move::D_PRIME: return "D'";
-        case RubiksCube::Move::D2: return "D2";
-        case RubiksCube::Move::R: return "R";
-        case RubiksCube::Move::R_PRIME: return "R'";
-        case RubiksCube::Move::R2: return "R2";
-        case RubiksCube::Move::L: return "L";
-        case RubiksCube::Move::L_PRIME: return "L'";
-        case RubiksCube::Move::L2: return "L2";
-        case RubiksCube::Move::F: return "F";
-        case RubiksCube::Move::F_PRIME: return "F'";
-        case RubiksCube::Move::F2: return "F2";
-        case RubiksCube::Move::B: return "B";
-        case RubiksCube::Move::B_PRIME: return "B'";
-        case RubiksCube::Move::B2: return "B2";
+void RubiksCube::applyMoves(const std::string& moves) {
+    // Parse space-separated moves in place and apply each one sequentially
+    const ParseResult result = forEachMove(moves, [this](Move m) { applyMove(m); });
+    if (!result) {
+        throw std::invalid_argument("Invalid move at position " + std::to_string(result.position) +
+                                    ": " + parseErrorMessage(result.error));
     }
-    return "";
 }
 
-void RubiksCube::applyMove(RubiksCube::Move move) {
-    applyMove(moveEnumToString(move));
-}
-
-void RubiksCube::applyMoves(const std::string& moves) {
-    // Parse space-separated moves and apply each one sequentially
-    std::stringstream ss(moves);
-    std::string m;
-    while (ss >> m) {
-        applyMove(m);
+void RubiksCube::applyMoves(const MoveSequence& moves) {
+    for (size_t i = 0; i < moves.size(); ++i) {
+        applyMove(moves[i]);
     }
 }
 
 std::string RubiksCube::scramble(int length) {
-    initMoveTablesOnce();
-    
-    // Build list of all available moves (cached after first call)
-    static std::vector<std::string> allMoves;
-    if (allMoves.empty()) {
-        allMoves.reserve(g_moveTables.size());
-        for (const auto& kv : g_moveTables) {
-            allMoves.push_back(kv.first);
-        }
-    }
-
-    // Set up random number generation
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, (int)allMoves.size() - 1);
+    // One generator per thread, seeded once, instead of a fresh engine per call
+    thread_local ScrambleGenerator gen(((uint64_t)std::random_device{}() << 32) ^ std::random_device{}());
 
-    // Generate and apply random moves
-    std::stringstream ss;
-    for (int i = 0; i < length; ++i) {
-        const std::string& m = allMoves[(size_t)dis(gen)];
-        ss << m;
-        if (i + 1 < length) ss << ' ';  // Add space between moves
-        applyMove(m);
+    // Generate and apply random moves, one packed sequence at a time; the
+    // last face carries over so the filtering also holds across pieces
+    std::string text;
+    int prevFace = ScrambleGenerator::kNoPreviousFace;
+    MoveSequence seq;
+    for (int done = 0; done < length;) {
+        const size_t n = std::min<size_t>((size_t)(length - done), MoveSequence::kCapacity);
+        gen.next(n, seq, prevFace);
+        applyMoves(seq);
+        done += (int)n;
+        if (!text.empty()) text += ' ';
+        text += seq.toString();
     }
-    return ss.str();
+    return text;
 }
 
 std::string RubiksCube::toString() const {
@@ -304,23 +279,36 @@ std::string RubiksCube::toString() const {
     return ss.str();
 }
 
+RubiksCube RubiksCube::fromFacelets(std::string_view facelets) {
+    CubeState state;
+    const StateError error = ::fromFacelets(facelets, state);
+    if (error != StateError::None) {
+        throw std::invalid_argument(std::string("Invalid facelets: ") + stateErrorMessage(error));
+    }
+    return state.toCube();
+}
+
+std::string RubiksCube::toFacelets() const {
+    std::string text(kFaceletCount, ' ');
+    ::toFacelets(CubeState::fromCube(*this), text.data());
+    return text;
+}
+
 void RubiksCube::rotate(int face, int direction) {
     /**
-     * Maps numeric face/direction to Singmaster notation and applies the move.
+     * Maps numeric face/direction to an enumerated move and applies it.
      * 
      * Face mapping: 0=U, 1=D, 2=R, 3=L, 4=F, 5=B
      * Direction: 1=clockwise, -1=counter-clockwise, 2/-2=double turn
      * 
-     * This provides a convenient numeric interface for external callers
-     * while internally using the string-based move system.
+     * The face order matches RubiksCube::Move, so the move index is
+     * 3 * face plus the variant offset.
      */
-    static const char* names[] = {"U","D","R","L","F","B"};
     if (face < 0 || face > 5) return;  // Ignore invalid face indices
     
-    std::string move = names[face];
-    if (direction == -1) move += "'";          // Counter-clockwise
-    else if (direction == 2 || direction == -2) move += "2";  // Double turn
-    // Default case (direction == 1): use base move (clockwise)
+    int variant = 0;                                           // Default (direction == 1): clockwise
+    if (direction == -1) variant = 1;                          // Counter-clockwise
+    else if (direction == 2 || direction == -2) variant = 2;   // Double turn
     
-    applyMove(move);
+    applyMove(static_cast<Move>(3 * face + variant));
 }
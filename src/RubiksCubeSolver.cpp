@@ -1,10 +1,244 @@
+/**
+ * @file RubiksCubeSolver.cpp
+ * @brief Dispatch from RubiksCubeSolver to the search back ends
+ */
+
 #include "../include/RubiksCubeSolver.hpp"
+#include "../include/CubeState.hpp"
+#include "../include/Facelets.hpp"
+#include "../include/OptimalSolver.hpp"
+#include "../include/ThistlethwaiteSolver.hpp"
+#include "../include/TwoPhaseSolver.hpp"
+#include "../include/WorkStealing.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+    /**
+     * @brief Process-wide handle on one method's tables that can be polled without blocking
+     *
+     * The tables themselves are the Tables::instance() singleton; the slot
+     * only publishes a pointer to them once they are complete, so a solve
+     * can check for them without waiting on a build in progress.
+     */
+    template <typename Tables>
+    class TableSlot {
+        std::atomic<const Tables*> live{nullptr};
+        std::atomic<bool> building{false};
+
+    public:
+        /**
+         * @brief Returns the tables if they are complete, else null
+         */
+        const Tables* tryGet() const { return this->live.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Returns the tables, building them on this thread if needed
+         * @throws Whatever the build threw, e.g. std::bad_alloc; a later call
+         *         or startBackground() tries again
+         */
+        const Tables& get() {
+            if (const Tables* tables = tryGet()) return *tables;
+            const Tables& tables = Tables::instance();
+            this->live.store(&tables, std::memory_order_release);
+            return tables;
+        }
+
+        /**
+         * @brief Starts get() on a detached thread unless the tables are live or building
+         *
+         * A failed build is dropped: the slot goes back to Absent and solves
+         * keep falling back until a later call starts another build. The
+         * thread refers to this slot, so the process must not run static
+         * destructors while it is in flight (see buildTablesInBackground).
+         */
+        void startBackground() {
+            bool idle = false;
+            if (tryGet() || !this->building.compare_exchange_strong(idle, true)) return;
+            std::thread([this] {
+                try {
+                    get();
+                } catch (...) {
+                    // Only the thread that set building may clear it
+                    this->building.store(false, std::memory_order_relaxed);
+                }
+            }).detach();
+        }
+
+        TableState state() const {
+            if (tryGet()) return TableState::Live;
+            return this->building.load(std::memory_order_relaxed) ? TableState::Building : TableState::Absent;
+        }
+    };
+
+    TableSlot<TwoPhaseTables> g_twoPhaseTables;
+    TableSlot<OptimalTables> g_optimalTables;
+    TableSlot<ThistlethwaiteTables> g_thistlethwaiteTables;
+
+    bool tablesLive(SolveMethod method) {
+        switch (method) {
+            case SolveMethod::TwoPhase: return g_twoPhaseTables.tryGet() != nullptr;
+            case SolveMethod::Optimal: return g_optimalTables.tryGet() != nullptr;
+            case SolveMethod::Thistlethwaite: return g_thistlethwaiteTables.tryGet() != nullptr;
+        }
+        return false;
+    }
 
+    /**
+     * @brief Picks the method that answers now: the configured one, or a fallback with live tables
+     */
+    SolveMethod answeringMethod(const SolverConfig& config) {
+        if (config.waitForTables || tablesLive(config.method)) return config.method;
+        RubiksCubeSolver::buildTablesInBackground(config.method);
+        if (config.method == SolveMethod::Optimal && tablesLive(SolveMethod::TwoPhase)) return SolveMethod::TwoPhase;
+        return SolveMethod::Thistlethwaite;
+    }
+
+    /**
+     * @brief Converts a cube to a state, rejecting unreachable ones
+     */
+    CubeState validated(const RubiksCube& cube) {
+        const CubeState state = CubeState::fromCube(cube);
+        const StateError error = validateState(state);
+        if (error != StateError::None) {
+            throw std::invalid_argument(std::string("Unsolvable cube: ") + stateErrorMessage(error));
+        }
+        return state;
+    }
+
+    /**
+     * @brief Returns the limits of a plain solve() starting now
+     */
+    SearchLimits solveLimits(const SolverConfig& config) {
+        SearchLimits limits;
+        limits.maxLength = config.maxLength;
+        limits.targetLength = config.targetLength;
+        if (config.timeout.count() > 0) {
+            limits.deadline = std::chrono::steady_clock::now() + config.timeout;
+        }
+        return limits;
+    }
+
+    /**
+     * @brief Builds the tables of a method ahead of time, unless the solver falls back instead
+     */
+    void warmUp(const SolverConfig& config) {
+        if (!config.waitForTables) return;
+        switch (config.method) {
+            case SolveMethod::TwoPhase: g_twoPhaseTables.get(); break;
+            case SolveMethod::Optimal: g_optimalTables.get(); break;
+            case SolveMethod::Thistlethwaite: g_thistlethwaiteTables.get(); break;
+        }
+    }
+
+    /**
+     * @brief Runs the configured back end, or its fallback while its tables build
+     */
+    SolveResult dispatch(const SolverConfig& config, const CubeState& state, const SearchLimits& limits,
+                         const SolutionCallback& onSolution) {
+        const SolveMethod method = answeringMethod(config);
+        SolveResult result;
+        switch (method) {
+            case SolveMethod::TwoPhase:
+                result = config.allOrientations
+                    ? solveTwoPhaseAllOrientations(state, limits, onSolution, g_twoPhaseTables.get())
+                    : solveTwoPhase(state, limits, onSolution, nullptr, g_twoPhaseTables.get());
+                result.degraded = method != config.method;
+                return result;
+            case SolveMethod::Optimal:
+                result = solveOptimal(state, limits, {config.threads, config.deterministic}, g_optimalTables.get());
+                break;
+            case SolveMethod::Thistlethwaite:
+                result = solveThistlethwaite(state, limits, g_thistlethwaiteTables.get());
+                break;
+            default:
+                throw std::invalid_argument("Unknown solve method");
+        }
+        result.degraded = method != config.method;
+        if (result.solved && onSolution) onSolution(result.moves);
+        return result;
+    }
+}
+
+RubiksCubeSolver::RubiksCubeSolver(const SolverConfig& config)
+    : settings(config) {
+    if (!config.waitForTables) buildTablesInBackground(config.method);
+}
 
-RubiksCubeSolver::RubiksCubeSolver() {
-    std::cout << "RubiksCubeSolver constructor" << std::endl;
+void RubiksCubeSolver::setConfig(const SolverConfig& config) {
+    this->settings = config;
+    if (!config.waitForTables) buildTablesInBackground(config.method);
 }
 
-RubiksCubeSolver::~RubiksCubeSolver() {
-    std::cout << "RubiksCubeSolver destructor" << std::endl;
-}
\ No newline at end of file
+SolveResult RubiksCubeSolver::solve(const RubiksCube& cube) const {
+    const CubeState state = validated(cube);
+    return dispatch(this->settings, state, solveLimits(this->settings), {});
+}
+
+SolveResult RubiksCubeSolver::solveWithin(const RubiksCube& cube, std::chrono::steady_clock::time_point deadline,
+                                          const SolutionCallback& onImprovement,
+                                          const std::atomic<bool>* cancel) const {
+    const CubeState state = validated(cube);
+
+    SearchLimits limits;
+    limits.maxLength = this->settings.maxLength;
+    // With no explicit target, a length of 0 is never beaten, so the search
+    // improves until the deadline or until it has ruled out shorter solutions
+    limits.targetLength = this->settings.targetLength < 0 ? 0 : this->settings.targetLength;
+    limits.deadline = deadline;
+    limits.cancel = cancel;
+    return dispatch(this->settings, state, limits, onImprovement);
+}
+
+SolveResult RubiksCubeSolver::solveWithin(const RubiksCube& cube, std::chrono::microseconds budget,
+                                          const SolutionCallback& onImprovement,
+                                          const std::atomic<bool>* cancel) const {
+    return solveWithin(cube, std::chrono::steady_clock::now() + budget, onImprovement, cancel);
+}
+
+std::vector<SolveResult> RubiksCubeSolver::solveBatch(std::span<const RubiksCube> cubes, unsigned threads) const {
+    std::vector<CubeState> states(cubes.size());
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        try {
+            states[i] = validated(cubes[i]);
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Cube " + std::to_string(i) + ": " + e.what());
+        }
+    }
+
+    SolverConfig single = this->settings;
+    single.threads = 1;
+    single.allOrientations = false;
+    warmUp(single);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (single.interleave > 1 && answeringMethod(single) == SolveMethod::Optimal) {
+        SearchLimits limits;
+        limits.maxLength = single.maxLength;
+        return solveOptimalBatch(states, limits, {threads, single.interleave, single.timeout}, g_optimalTables.get());
+    }
+    std::vector<SolveResult> results(cubes.size());
+    runWorkStealing(states.size(), threads, [&](size_t i, unsigned) {
+        results[i] = dispatch(single, states[i], solveLimits(single), {});
+    });
+    return results;
+}
+
+void RubiksCubeSolver::buildTablesInBackground(SolveMethod method) {
+    switch (method) {
+        case SolveMethod::TwoPhase: g_twoPhaseTables.startBackground(); break;
+        case SolveMethod::Optimal:
+            // The two-phase tables are ready long before the optimal ones and
+            // make a much better fallback than Thistlethwaite in the meantime
+            g_twoPhaseTables.startBackground();
+            g_optimalTables.startBackground();
+            break;
+        case SolveMethod::Thistlethwaite: g_thistlethwaiteTables.startBackground(); break;
+    }
+}
+
+TableStatus RubiksCubeSolver::tableStatus() {
+    return {g_twoPhaseTables.state(), g_optimalTables.state(), g_thistlethwaiteTables.state()};
+}
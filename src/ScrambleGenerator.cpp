@@ -0,0 +1,126 @@
+/**
+ * @file ScrambleGenerator.cpp
+ * @brief xoshiro256** scramble generation with canonical move filtering
+ */
+
+#include "../include/ScrambleGenerator.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Moves allowed after a turn of a given face
+     *
+     * Row 6 (kNoPreviousFace) is used for the first move. Faces are
+     * ordered U, D, R, L, F, B so opposite faces are pairs (2k, 2k+1);
+     * after the second face of a pair the first one is excluded as well.
+     */
+    struct AllowedMoves {
+        uint8_t count;                 ///< Number of allowed moves
+        std::array<uint8_t, 18> moves; ///< Allowed moves, by enum value
+    };
+
+    constexpr std::array<AllowedMoves, 7> buildAllowedMoves() {
+        std::array<AllowedMoves, 7> table{};
+        for (int prev = 0; prev <= 6; ++prev) {
+            for (int face = 0; face < 6; ++face) {
+                if (prev < 6 && (face == prev || (face / 2 == prev / 2 && face < prev))) continue;
+                for (int v = 0; v < 3; ++v) {
+                    table[prev].moves[table[prev].count++] = (uint8_t)(3 * face + v);
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<AllowedMoves, 7> g_allowedMoves = buildAllowedMoves();
+
+    uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    void checkLength(size_t length) {
+        if (length > MoveSequence::kCapacity) {
+            throw std::invalid_argument("Scramble length exceeds MoveSequence capacity: " +
+                                        std::to_string(length));
+        }
+    }
+}
+
+ScrambleGenerator::ScrambleGenerator(uint64_t seed, uint64_t stream) {
+    // Mix the stream into the seed first so neighbouring streams share no state words
+    uint64_t x = seed;
+    x = splitmix64(x) ^ stream;
+    for (uint64_t& word : this->state) word = splitmix64(x);
+}
+
+uint64_t ScrambleGenerator::nextRandom() {
+    std::array<uint64_t, 4>& s = this->state;
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+MoveSequence ScrambleGenerator::next(size_t length) {
+    MoveSequence out;
+    next(length, out);
+    return out;
+}
+
+void ScrambleGenerator::next(size_t length, MoveSequence& out) {
+    int prev = kNoPreviousFace;
+    next(length, out, prev);
+}
+
+void ScrambleGenerator::next(size_t length, MoveSequence& out, int& prevFace) {
+    checkLength(length);
+    out.clear();
+    for (size_t i = 0; i < length; ++i) {
+        const AllowedMoves& allowed = g_allowedMoves[prevFace];
+        // Map the top 32 bits onto [0, count) with a multiply instead of a division
+        const uint64_t r = nextRandom() >> 32;
+        const uint8_t move = allowed.moves[(r * allowed.count) >> 32];
+        out.push_back(static_cast<RubiksCube::Move>(move));
+        prevFace = move / 3;
+    }
+}
+
+void ScrambleGenerator::generateBatch(uint64_t seed, size_t length, std::span<MoveSequence> out,
+                                      unsigned threads) {
+    checkLength(length);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    // Below a few thousand scrambles the thread start-up costs more than it saves
+    constexpr size_t kMinPerThread = 4096;
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(1, out.size() / kMinPerThread));
+
+    auto work = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ScrambleGenerator(seed, i).next(length, out[i]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const size_t chunk = (out.size() + threads - 1) / threads;
+    for (unsigned t = 1; t < threads; ++t) {
+        const size_t begin = std::min(out.size(), t * chunk);
+        const size_t end = std::min(out.size(), begin + chunk);
+        workers.emplace_back(work, begin, end);
+    }
+    work(0, std::min(out.size(), chunk));
+    for (std::thread& w : workers) w.join();
+}
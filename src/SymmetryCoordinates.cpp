@@ -0,0 +1,89 @@
+/**
+ * @file SymmetryCoordinates.cpp
+ * @brief Construction of symmetry classes and conjugation tables
+ */
+
+#include "../include/SymmetryCoordinates.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Returns one state for every coordinate value, found by breadth-first search from solved
+     * @throws std::logic_error if some value is never reached
+     */
+    template <typename CoordOf>
+    std::vector<CubeState> representativeStates(size_t size, CoordOf coordOf, std::span<const RubiksCube::Move> moves) {
+        std::vector<CubeState> states(size);
+        std::vector<uint8_t> seen(size, 0);
+        std::vector<uint32_t> queue;
+        queue.reserve(size);
+
+        const CubeState solved = CubeState::solved();
+        const uint32_t start = coordOf(solved);
+        states[start] = solved;
+        seen[start] = 1;
+        queue.push_back(start);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (RubiksCube::Move m : moves) {
+                const CubeState child = states[queue[head]].moved(m);
+                const uint32_t c = coordOf(child);
+                if (c >= size) throw std::logic_error("Coordinate out of range: " + std::to_string(c));
+                if (seen[c]) continue;
+                seen[c] = 1;
+                states[c] = child;
+                queue.push_back(c);
+            }
+        }
+        if (queue.size() != size) {
+            throw std::logic_error("Symmetry table reached " + std::to_string(queue.size()) +
+                                   " of " + std::to_string(size) + " values");
+        }
+        return states;
+    }
+
+    constexpr uint32_t kUnclassified = 0xFFFFFFFF;
+}
+
+uint32_t flipSliceCoord(const CubeState& s) {
+    return (uint32_t)sliceCoord(s) * kFlipCount + flipCoord(s);
+}
+
+SymCoordTable SymCoordTable::build(size_t size, uint32_t (*coordOf)(const CubeState&),
+                                   std::span<const RubiksCube::Move> moves) {
+    const std::vector<CubeState> states = representativeStates(size, coordOf, moves);
+    std::vector<uint32_t> classOf(size, kUnclassified);
+    std::vector<uint32_t> reps;
+    std::vector<uint16_t> selfSyms;
+    for (size_t raw = 0; raw < size; ++raw) {
+        if (classOf[raw] != kUnclassified) continue;
+        const uint32_t cls = (uint32_t)reps.size();
+        reps.push_back((uint32_t)raw);
+        uint16_t fixed = 0;
+        for (size_t s = 0; s < kUDSymmetryCount; ++s) {
+            // The conjugate by s goes back to the representative by s's inverse
+            const uint32_t c = coordOf(conjugateUD(states[raw], s));
+            if (c >= size) throw std::logic_error("Conjugate out of range: " + std::to_string(c));
+            if (classOf[c] == kUnclassified) classOf[c] = (cls << 4) | g_udSymmetryInverse[s];
+            if (c == raw) fixed |= (uint16_t)(1u << s);
+        }
+        selfSyms.push_back(fixed);
+    }
+    return SymCoordTable(TableStorage<uint32_t>(std::move(classOf)), TableStorage<uint32_t>(std::move(reps)),
+                         TableStorage<uint16_t>(std::move(selfSyms)));
+}
+
+SymConjugationTable SymConjugationTable::build(size_t size, uint16_t (*coordOf)(const CubeState&),
+                                               std::span<const RubiksCube::Move> moves) {
+    const std::vector<CubeState> states = representativeStates(size, coordOf, moves);
+    std::vector<uint16_t> conj(size * kUDSymmetryCount);
+    for (size_t coord = 0; coord < size; ++coord) {
+        for (size_t s = 0; s < kUDSymmetryCount; ++s) {
+            const uint16_t c = coordOf(conjugateUD(states[coord], s));
+            if (c >= size) throw std::logic_error("Conjugate out of range: " + std::to_string(c));
+            conj[coord * kUDSymmetryCount + s] = c;
+        }
+    }
+    return SymConjugationTable(TableStorage<uint16_t>(std::move(conj)));
+}
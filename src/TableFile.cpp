@@ -0,0 +1,266 @@
+/**
+ * @file TableFile.cpp
+ * @brief Reading, validating and atomically writing table files
+ */
+
+#include "../include/TableFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <random>
+
+#if defined(_WIN32)
+#define RUBIKS_TABLE_MMAP 0
+#else
+#define RUBIKS_TABLE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char kMagic[8] = {'R', 'C', 'S', 'T', 'A', 'B', 'L', 'E'};
+
+    /// Reads back as another value on a machine of the other byte order
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+
+    /// Alignment of every section payload within the file
+    constexpr uint64_t kSectionAlign = 64;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t kind;
+        uint32_t byteOrder;
+        uint32_t sectionCount;
+        uint64_t payloadBytes;  ///< Bytes after the header: descriptors and sections
+        uint64_t checksum;      ///< checksum() of those bytes
+    };
+
+    struct SectionHeader {
+        uint64_t offset;        ///< From the start of the file
+        uint64_t count;
+        uint32_t elementSize;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 40 && sizeof(SectionHeader) == 24, "Table file headers must not be padded");
+
+    /**
+     * @brief Streaming 64-bit checksum
+     *
+     * Four independent multiply-xor lanes over 8-byte words keep the CPU
+     * busy enough to check a few hundred megabytes in tens of milliseconds;
+     * any single changed byte changes the result. Feeding the bytes in
+     * pieces gives the same result as feeding them at once.
+     */
+    class Checksum {
+        static constexpr uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+        uint64_t lane[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+        unsigned char carry[32];
+        size_t carried = 0;
+        uint64_t total = 0;
+
+        void block(const unsigned char* data) {
+            for (int k = 0; k < 4; ++k) {
+                uint64_t w;
+                std::memcpy(&w, data + 8 * k, 8);
+                lane[k] = (lane[k] ^ w) * kMul;
+                lane[k] ^= lane[k] >> 32;
+            }
+        }
+
+    public:
+        void update(const unsigned char* data, size_t size) {
+            this->total += size;
+            if (this->carried > 0) {
+                const size_t n = std::min(size, sizeof carry - this->carried);
+                std::memcpy(carry + this->carried, data, n);
+                this->carried += n;
+                data += n;
+                size -= n;
+                if (this->carried < sizeof carry) return;
+                block(carry);
+                this->carried = 0;
+            }
+            for (; size >= sizeof carry; data += sizeof carry, size -= sizeof carry) block(data);
+            std::memcpy(carry, data, size);
+            this->carried = size;
+        }
+
+        uint64_t finish() const {
+            uint64_t h = this->total;
+            for (int k = 0; k < 4; ++k) h = (h ^ lane[k]) * kMul;
+            for (size_t i = 0; i < this->carried; ++i) h = (h ^ carry[i]) * kMul;
+            return h ^ (h >> 29);
+        }
+    };
+
+    uint64_t alignUp(uint64_t n) {
+        return (n + kSectionAlign - 1) / kSectionAlign * kSectionAlign;
+    }
+
+    /**
+     * @brief Flushes a written file to the disk, so a rename after it survives a crash
+     * @return false if the file could not be opened or synced
+     *
+     * A no-op without POSIX file descriptors.
+     */
+    bool syncFile(const std::string& path) {
+#if RUBIKS_TABLE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        const bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+#else
+        (void)path;
+        return true;
+#endif
+    }
+
+    std::mutex g_directoryLock;
+    std::string g_tableDirectory;
+}
+
+TableFile::~TableFile() {
+#if RUBIKS_TABLE_MMAP
+    if (this->buffer.empty() && this->base) munmap(const_cast<unsigned char*>(this->base), this->length);
+#endif
+}
+
+std::shared_ptr<const TableFile> TableFile::open(const std::string& path, uint32_t kind, size_t sectionCount) {
+    // Private constructor, so no make_shared
+    std::shared_ptr<TableFile> file(new TableFile());
+
+#if RUBIKS_TABLE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw TableFileError("Cannot open table file " + path);
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(FileHeader)) {
+        ::close(fd);
+        throw TableFileError("Table file too short: " + path);
+    }
+    file->length = (size_t)info.st_size;
+    void* mapped = mmap(nullptr, file->length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) throw TableFileError("Cannot map table file " + path);
+    file->base = static_cast<const unsigned char*>(mapped);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw TableFileError("Cannot open table file " + path);
+    file->buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (file->buffer.size() < sizeof(FileHeader)) throw TableFileError("Table file too short: " + path);
+    file->base = file->buffer.data();
+    file->length = file->buffer.size();
+#endif
+
+    FileHeader header;
+    std::memcpy(&header, file->base, sizeof header);
+    if (std::memcmp(header.magic, kMagic, sizeof kMagic) != 0) throw TableFileError("Not a table file: " + path);
+    if (header.formatVersion != kTableFormatVersion || header.kind != kind || header.byteOrder != kByteOrderMark ||
+        header.sectionCount != sectionCount) {
+        throw TableFileError("Table file has another version or layout: " + path);
+    }
+    if (header.payloadBytes != file->length - sizeof(FileHeader) ||
+        header.payloadBytes < (uint64_t)sectionCount * sizeof(SectionHeader)) {
+        throw TableFileError("Table file truncated: " + path);
+    }
+    Checksum sum;
+    sum.update(file->base + sizeof(FileHeader), header.payloadBytes);
+    if (sum.finish() != header.checksum) {
+        throw TableFileError("Table file checksum mismatch: " + path);
+    }
+
+    for (size_t i = 0; i < sectionCount; ++i) {
+        SectionHeader s;
+        std::memcpy(&s, file->base + sizeof(FileHeader) + i * sizeof(SectionHeader), sizeof s);
+        // Divides rather than multiplies, so a huge count cannot wrap past the check
+        if (s.offset % kSectionAlign != 0 || s.offset > file->length || s.elementSize == 0 ||
+            s.count > (file->length - s.offset) / s.elementSize) {
+            throw TableFileError("Table file section out of bounds: " + path);
+        }
+        file->sections.push_back({s.offset, s.count, s.elementSize});
+    }
+    return file;
+}
+
+const void* TableFile::sectionData(size_t index, size_t elementSize, size_t count) const {
+    if (index >= this->sections.size()) throw TableFileError("Missing table file section " + std::to_string(index));
+    const Section& s = this->sections[index];
+    if (s.elementSize != elementSize || s.count != count) {
+        throw TableFileError("Table file section " + std::to_string(index) + " has the wrong geometry");
+    }
+    return this->base + s.offset;
+}
+
+void TableFileWriter::commit(const std::string& path) const {
+    // Descriptors, padded so the first section starts aligned
+    std::vector<unsigned char> head(alignUp(sizeof(FileHeader) + this->pending.size() * sizeof(SectionHeader)) -
+                                    sizeof(FileHeader), 0);
+    uint64_t offset = sizeof(FileHeader) + head.size();
+    for (size_t i = 0; i < this->pending.size(); ++i) {
+        const Pending& p = this->pending[i];
+        const SectionHeader s{offset, p.count, p.elementSize, 0};
+        std::memcpy(head.data() + i * sizeof(SectionHeader), &s, sizeof s);
+        offset = alignUp(offset + p.count * p.elementSize);
+    }
+
+    // A unique temporary name lets concurrent writers race safely: each
+    // rename is atomic and every candidate file is complete
+    const std::string temp = path + ".tmp" + std::to_string(std::random_device{}());
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    Checksum sum;
+    auto emit = [&](const void* data, size_t size) {
+        sum.update(static_cast<const unsigned char*>(data), size);
+        out.write(static_cast<const char*>(data), (std::streamsize)size);
+    };
+
+    FileHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);  // Filled in last
+    emit(head.data(), head.size());
+    const unsigned char padding[kSectionAlign] = {};
+    for (const Pending& p : this->pending) {
+        const size_t bytes = p.count * p.elementSize;
+        emit(p.data, bytes);
+        emit(padding, alignUp(bytes) - bytes);
+    }
+
+    std::memcpy(header.magic, kMagic, sizeof kMagic);
+    header.formatVersion = kTableFormatVersion;
+    header.kind = this->kind;
+    header.byteOrder = kByteOrderMark;
+    header.sectionCount = (uint32_t)this->pending.size();
+    header.payloadBytes = offset - sizeof(FileHeader);
+    header.checksum = sum.finish();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);
+    out.close();
+    if (!out || !syncFile(temp)) {
+        std::remove(temp.c_str());
+        throw TableFileError("Cannot write table file " + temp);
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error) {
+        std::remove(temp.c_str());
+        throw TableFileError("Cannot replace table file " + path + ": " + error.message());
+    }
+}
+
+void setTableDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> guard(g_directoryLock);
+    g_tableDirectory = directory;
+}
+
+std::string tableFilePath(const std::string& name) {
+    std::lock_guard<std::mutex> guard(g_directoryLock);
+    if (g_tableDirectory.empty()) return "";
+    return (std::filesystem::path(g_tableDirectory) / name).string();
+}
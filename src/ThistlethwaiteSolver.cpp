@@ -0,0 +1,287 @@
+/**
+ * @file ThistlethwaiteSolver.cpp
+ * @brief Phase coordinates, table construction and downhill descent
+ */
+
+#include "../include/ThistlethwaiteSolver.hpp"
+#include <array>
+#include <bit>
+#include <span>
+
+namespace {
+    using Move = RubiksCube::Move;
+
+    /// Phase 2 moves <U, D, R, L, F2, B2>, which preserve edge orientation
+    constexpr Move g_edgeOrientedMoves[14] = {
+        Move::U, Move::U_PRIME, Move::U2, Move::D, Move::D_PRIME, Move::D2,
+        Move::R, Move::R_PRIME, Move::R2, Move::L, Move::L_PRIME, Move::L2,
+        Move::F2, Move::B2
+    };
+
+    // Phase 3 uses g_phase2Moves <U, D, R2, L2, F2, B2>: Kociemba's G1 is Thistlethwaite's G2
+
+    /// Phase 4 moves: half turns only
+    constexpr Move g_halfTurns[6] = {Move::U2, Move::D2, Move::R2, Move::L2, Move::F2, Move::B2};
+
+    /**
+     * @brief Maps a set of 4 slots out of 8 (as a bitmask) to its rank among the 70 such sets
+     */
+    constexpr std::array<uint8_t, 256> buildComboIndex() {
+        std::array<uint8_t, 256> table{};
+        uint8_t next = 0;
+        for (int mask = 0; mask < 256; ++mask) {
+            table[mask] = std::popcount((unsigned)mask) == 4 ? next++ : 0xFF;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint8_t, 256> g_comboIndex = buildComboIndex();
+
+    /**
+     * @brief Rank (0-23) of the order of four pieces
+     */
+    uint16_t rank4(std::array<uint8_t, 4> p) {
+        int rank = 0;
+        for (int i = 0; i < 3; ++i) {
+            int smaller = 0;
+            for (int j = i + 1; j < 4; ++j) smaller += p[j] < p[i];
+            rank = rank * (4 - i) + smaller;
+        }
+        return (uint16_t)rank;
+    }
+
+    /// Which U/D-layer slots (0-7) hold the M-slice edges UF, UB, DF, DB
+    uint16_t mComboCoord(const CubeState& s) {
+        unsigned mask = 0;
+        for (int i = 0; i < 8; ++i) {
+            if (s.edgePiece(i) % 2 == 1) mask |= 1u << i;
+        }
+        return g_comboIndex[mask];
+    }
+
+    /// Order of the M-slice edges in slots UF, UB, DF, DB
+    uint16_t mPermCoord(const CubeState& s) {
+        return rank4({s.edgePiece(1), s.edgePiece(3), s.edgePiece(5), s.edgePiece(7)});
+    }
+
+    /// Order of the S-slice edges in slots UR, UL, DR, DL
+    uint16_t sPermCoord(const CubeState& s) {
+        return rank4({s.edgePiece(0), s.edgePiece(2), s.edgePiece(4), s.edgePiece(6)});
+    }
+
+    /**
+     * @brief Collects the corner permutations reachable with half turns
+     */
+    std::vector<uint16_t> halfTurnCorners(const CoordMoveTable& cornerPerm) {
+        std::vector<uint16_t> found{0};
+        std::vector<uint8_t> seen(kCornerPermCount, 0);
+        seen[0] = 1;
+        for (size_t head = 0; head < found.size(); ++head) {
+            for (Move m : g_halfTurns) {
+                const uint16_t next = cornerPerm(found[head], m);
+                if (!seen[next]) {
+                    seen[next] = 1;
+                    found.push_back(next);
+                }
+            }
+        }
+        return found;
+    }
+
+    std::vector<uint8_t> indexCorners(const std::vector<uint16_t>& corners) {
+        std::vector<uint8_t> index(kCornerPermCount, 0xFF);
+        for (size_t i = 0; i < corners.size(); ++i) index[corners[i]] = (uint8_t)i;
+        return index;
+    }
+
+    // Phase 3 and 4 indices combine several coordinates
+    size_t phase3Index(size_t cornerPerm, size_t mCombo) {
+        return cornerPerm * 70 + mCombo;
+    }
+
+    size_t phase4Index(size_t g3Corner, size_t m, size_t s, size_t e) {
+        return ((g3Corner * 24 + m) * 24 + s) * 24 + e;
+    }
+
+    PruningTable buildPhase3(const ThistlethwaiteTables& t, const TableBuildOptions& options) {
+        // G3 is reached once the corners form a half-turn permutation and
+        // the M-slice edges are home, whatever the other edges do
+        const uint16_t home = mComboCoord(CubeState::solved());
+        std::vector<size_t> goals;
+        for (uint16_t cp : t.g3Corners) goals.push_back(phase3Index(cp, home));
+        return PruningTable::build(kThistlethwaitePhase3Count, std::span<const size_t>(goals),
+                                   [&](size_t index, auto&& visit) {
+                                       const size_t cp = index / 70;
+                                       const size_t combo = index % 70;
+                                       for (Move m : g_phase2Moves) {
+                                           visit(phase3Index(t.cornerPerm(cp, m), t.mCombo(combo, m)));
+                                       }
+                                   }, options);
+    }
+}
+
+ThistlethwaiteTables::ThistlethwaiteTables(const TableBuildOptions& options)
+    : flip(CoordMoveTable::build(kFlipCount, flipCoord, g_allMoves)),
+      twist(CoordMoveTable::build(kTwistCount, twistCoord, g_edgeOrientedMoves)),
+      slice(CoordMoveTable::build(kSliceCount, sliceCoord, g_edgeOrientedMoves)),
+      cornerPerm(CoordMoveTable::build(kCornerPermCount, cornerPermCoord, g_phase2Moves)),
+      mCombo(CoordMoveTable::build(70, mComboCoord, g_phase2Moves)),
+      mPerm(CoordMoveTable::build(24, mPermCoord, g_halfTurns)),
+      sPerm(CoordMoveTable::build(24, sPermCoord, g_halfTurns)),
+      ePerm(CoordMoveTable::build(24, slicePermCoord, g_halfTurns)),
+      g3Corners(halfTurnCorners(cornerPerm)),
+      g3CornerIndex(indexCorners(g3Corners)),
+      phase1(PruningTable::build(flip.size(), 0, [&](size_t f, auto&& visit) {
+          for (Move m : g_allMoves) visit(flip(f, m));
+      }, options)),
+      phase2(PruningTable::build(twist, slice, g_edgeOrientedMoves, options)),
+      phase3(buildPhase3(*this, options)),
+      phase4(PruningTable::build(kThistlethwaitePhase4Count, 0, [&](size_t index, auto&& visit) {
+          const size_t e = index % 24;
+          const size_t s = index / 24 % 24;
+          const size_t m = index / 576 % 24;
+          const size_t c = index / 13824;
+          for (Move mv : g_halfTurns) {
+              visit(phase4Index(g3CornerIndex[cornerPerm(g3Corners[c], mv)], mPerm(m, mv), sPerm(s, mv), ePerm(e, mv)));
+          }
+      }, options)) {}
+
+ThistlethwaiteTables::ThistlethwaiteTables(const std::shared_ptr<const TableFile>& file)
+    : flip(file->section<uint16_t>(0, kFlipCount * kMoveCount)),
+      twist(file->section<uint16_t>(1, kTwistCount * kMoveCount)),
+      slice(file->section<uint16_t>(2, kSliceCount * kMoveCount)),
+      cornerPerm(file->section<uint16_t>(3, kCornerPermCount * kMoveCount)),
+      mCombo(file->section<uint16_t>(4, 70 * kMoveCount)),
+      mPerm(file->section<uint16_t>(5, 24 * kMoveCount)),
+      sPerm(file->section<uint16_t>(6, 24 * kMoveCount)),
+      ePerm(file->section<uint16_t>(7, 24 * kMoveCount)),
+      g3Corners(halfTurnCorners(cornerPerm)),
+      g3CornerIndex(indexCorners(g3Corners)),
+      phase1(file->section<uint8_t>(8, kFlipCount)),
+      phase2(file->section<uint8_t>(9, kTwistCount * kSliceCount)),
+      phase3(file->section<uint8_t>(10, kThistlethwaitePhase3Count)),
+      phase4(file->section<uint8_t>(11, kThistlethwaitePhase4Count)) {}
+
+const ThistlethwaiteTables& ThistlethwaiteTables::instance() {
+    static const ThistlethwaiteTables tables =
+        loadOrBuildTables<ThistlethwaiteTables>(tableFilePath("thistlethwaite.tables"), TableBuildOptions{});
+    return tables;
+}
+
+void ThistlethwaiteTables::save(const std::string& path) const {
+    TableFileWriter out(kFileKind);
+    for (const CoordMoveTable* m : {&flip, &twist, &slice, &cornerPerm, &mCombo, &mPerm, &sPerm, &ePerm}) {
+        out.add(m->storage());
+    }
+    for (const PruningTable* p : {&phase1, &phase2, &phase3, &phase4}) out.add(p->storage());
+    out.commit(path);
+}
+
+size_t ThistlethwaiteTables::bytes() const {
+    return flip.bytes() + twist.bytes() + slice.bytes() + cornerPerm.bytes() + mCombo.bytes() +
+           mPerm.bytes() + sPerm.bytes() + ePerm.bytes() + g3Corners.size() * sizeof(uint16_t) +
+           g3CornerIndex.size() + phase1.bytes() + phase2.bytes() + phase3.bytes() + phase4.bytes();
+}
+
+namespace {
+    /**
+     * @brief Walks one phase downhill in its distance table
+     * @param moves Moves allowed in the phase
+     * @param index Phase coordinate of the state at the start of the phase
+     * @param dist Returns the table distance of a phase coordinate
+     * @param next Returns the phase coordinate after a move
+     * @param out Receives the moves
+     * @param probes Counts table lookups
+     *
+     * The tables are exact, so some move always lowers the distance by one.
+     */
+    template <typename Dist, typename Next>
+    void descend(std::span<const Move> moves, size_t index, Dist dist, Next next,
+                 MoveSequence& out, uint64_t& probes) {
+        for (int d = dist(index); d > 0; --d) {
+            for (Move m : moves) {
+                const size_t child = next(index, m);
+                ++probes;
+                if (dist(child) == d - 1) {
+                    out.push_back(m);
+                    index = child;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Merges adjacent turns of the same face left where two phases meet
+     */
+    MoveSequence mergeSameFace(const MoveSequence& moves) {
+        // Quarter turns are counted as 1, primes as 3 and doubles as 2
+        static constexpr int amount[3] = {1, 3, 2};
+        static constexpr int variant[4] = {-1, 0, 2, 1};
+        std::array<int, MoveSequence::kCapacity> face{}, turns{};
+        size_t n = 0;
+        for (size_t i = 0; i < moves.size(); ++i) {
+            const int m = static_cast<int>(moves[i]);
+            if (n > 0 && face[n - 1] == m / 3) {
+                turns[n - 1] = (turns[n - 1] + amount[m % 3]) % 4;
+                if (turns[n - 1] == 0) --n;
+                continue;
+            }
+            face[n] = m / 3;
+            turns[n] = amount[m % 3];
+            ++n;
+        }
+        MoveSequence merged;
+        for (size_t i = 0; i < n; ++i) {
+            merged.push_back(static_cast<Move>(3 * face[i] + variant[turns[i]]));
+        }
+        return merged;
+    }
+}
+
+SolveResult solveThistlethwaite(const CubeState& state, const SearchLimits&, const ThistlethwaiteTables& t) {
+    const auto start = std::chrono::steady_clock::now();
+    SolveResult result;
+    MoveSequence moves;
+    uint64_t probes = 0;
+    CubeState s = state;
+
+    auto applyFrom = [&](size_t from) {
+        for (size_t i = from; i < moves.size(); ++i) s.applyMove(moves[i]);
+        return moves.size();
+    };
+
+    descend(g_allMoves, flipCoord(s),
+            [&](size_t f) { return t.phase1[f]; },
+            [&](size_t f, Move m) { return (size_t)t.flip(f, m); },
+            moves, probes);
+    size_t done = applyFrom(0);
+
+    descend(g_edgeOrientedMoves, twistCoord(s) * kSliceCount + sliceCoord(s),
+            [&](size_t i) { return t.phase2[i]; },
+            [&](size_t i, Move m) { return t.twist(i / kSliceCount, m) * kSliceCount + t.slice(i % kSliceCount, m); },
+            moves, probes);
+    done = applyFrom(done);
+
+    descend(g_phase2Moves, phase3Index(cornerPermCoord(s), mComboCoord(s)),
+            [&](size_t i) { return t.phase3[i]; },
+            [&](size_t i, Move m) { return phase3Index(t.cornerPerm(i / 70, m), t.mCombo(i % 70, m)); },
+            moves, probes);
+    done = applyFrom(done);
+
+    descend(g_halfTurns,
+            phase4Index(t.g3CornerIndex[cornerPermCoord(s)], mPermCoord(s), sPermCoord(s), slicePermCoord(s)),
+            [&](size_t i) { return t.phase4[i]; },
+            [&](size_t i, Move m) {
+                const size_t c = t.g3Corners[i / 13824];
+                return phase4Index(t.g3CornerIndex[t.cornerPerm(c, m)], t.mPerm(i / 576 % 24, m),
+                                   t.sPerm(i / 24 % 24, m), t.ePerm(i % 24, m));
+            },
+            moves, probes);
+
+    result.moves = mergeSameFace(moves);
+    result.solved = true;
+    result.stats.nodes = probes;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file TranspositionTable.cpp
+ * @brief Allocation, replacement and counters of the transposition table
+ */
+
+#include "../include/TranspositionTable.hpp"
+#include <algorithm>
+#include <bit>
+
+TranspositionTable::TranspositionTable(size_t bytes, ReplacementPolicy policy)
+    : buckets(std::bit_floor(std::max<size_t>(1, bytes / sizeof(Bucket)))),
+      mask(this->buckets.size() - 1), replacement(policy) {}
+
+void TranspositionTable::store(uint64_t key, int bound) {
+    const uint64_t tag = key & kTagMask;
+    const uint64_t word = tag | (uint64_t)bound;
+    Bucket& bucket = this->buckets[key & this->mask];
+
+    std::atomic<uint64_t>* victim = nullptr;
+    uint64_t victimBound = UINT64_MAX;
+    for (std::atomic<uint64_t>& entry : bucket.entries) {
+        const uint64_t old = entry.load(std::memory_order_relaxed);
+        if (old == 0) {
+            if (!victim || victimBound > 0) {
+                victim = &entry;
+                victimBound = 0;
+            }
+            continue;
+        }
+        if ((old & kTagMask) == tag) {
+            if ((old & ~kTagMask) < (uint64_t)bound) entry.store(word, std::memory_order_relaxed);
+            return;
+        }
+        if (this->replacement == ReplacementPolicy::DepthPreferred && (old & ~kTagMask) < victimBound) {
+            victim = &entry;
+            victimBound = old & ~kTagMask;
+        }
+    }
+    // An empty slot if there is one, else the smallest bound or, with
+    // Always, the slot named by the key's top bits
+    if (!victim) victim = &bucket.entries[key >> 62];
+    victim->store(word, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (Bucket& bucket : this->buckets) {
+        for (std::atomic<uint64_t>& entry : bucket.entries) entry.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TranspositionTable::record(const TranspositionCounters& counters) {
+    this->hits.fetch_add(counters.hits, std::memory_order_relaxed);
+    this->misses.fetch_add(counters.misses, std::memory_order_relaxed);
+    this->cutoffs.fetch_add(counters.cutoffs, std::memory_order_relaxed);
+    this->stores.fetch_add(counters.stores, std::memory_order_relaxed);
+}
+
+TranspositionCounters TranspositionTable::counters() const {
+    TranspositionCounters c;
+    c.hits = this->hits.load(std::memory_order_relaxed);
+    c.misses = this->misses.load(std::memory_order_relaxed);
+    c.cutoffs = this->cutoffs.load(std::memory_order_relaxed);
+    c.stores = this->stores.load(std::memory_order_relaxed);
+    return c;
+}
+
+void TranspositionTable::resetCounters() {
+    this->hits.store(0, std::memory_order_relaxed);
+    this->misses.store(0, std::memory_order_relaxed);
+    this->cutoffs.store(0, std::memory_order_relaxed);
+    this->stores.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,439 @@
+/**
+ * @file TwoPhaseSolver.cpp
+ * @brief Table construction and the two nested IDA* searches
+ */
+
+#include "../include/TwoPhaseSolver.hpp"
+#include "../include/Symmetry.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    uint32_t cornerPermRawCoord(const CubeState& s) {
+        return cornerPermCoord(s);
+    }
+
+    /**
+     * @brief Visits the entry of class @p cls and conjugated coordinate @p minor, then its symmetric twins
+     * @param minorCount Entries per class
+     *
+     * A forward breadth-first search only reaches one of the twins through
+     * any given move, so all of them are labelled at once.
+     */
+    template <typename Visit>
+    void visitWithTwins(const SymCoordTable& classes, const SymConjugationTable& conj, size_t cls, size_t minor,
+                        size_t minorCount, Visit&& visit) {
+        visit(cls * minorCount + minor);
+        for (unsigned twins = classes.symmetries(cls) & ~1u; twins != 0; twins &= twins - 1) {
+            visit(cls * minorCount + conj(minor, (size_t)std::countr_zero(twins)));
+        }
+    }
+
+    /**
+     * @brief Calls visit(child) for every flipSliceTwist entry one move from @p index
+     */
+    template <typename Visit>
+    void expandPhase1(const TwoPhaseTables& t, size_t index, Visit&& visit) {
+        const uint32_t rep = t.flipSliceSym.representative(index / kTwistCount);
+        const size_t tw = index % kTwistCount, fl = rep % kFlipCount, sl = rep / kFlipCount;
+        for (size_t m = 0; m < kMoveCount; ++m) {
+            const uint32_t sym = t.flipSliceSym[(size_t)t.slice(sl, m) * kFlipCount + t.flip(fl, m)];
+            visitWithTwins(t.flipSliceSym, t.twistConj, sym >> 4, t.twistConj(t.twist(tw, m), sym & 15), kTwistCount,
+                           visit);
+        }
+    }
+
+    /**
+     * @brief Calls visit(child) for every cornerEdge entry one phase-2 move from @p index
+     */
+    template <typename Visit>
+    void expandPhase2(const TwoPhaseTables& t, size_t index, Visit&& visit) {
+        const size_t cp = t.cornerPermSym.representative(index / kUDEdgePermCount), ep = index % kUDEdgePermCount;
+        for (RubiksCube::Move move : g_phase2Moves) {
+            const uint32_t sym = t.cornerPermSym[t.cornerPerm(cp, move)];
+            visitWithTwins(t.cornerPermSym, t.udEdgePermConj, sym >> 4, t.udEdgePermConj(t.udEdgePerm(ep, move), sym & 15),
+                           kUDEdgePermCount, visit);
+        }
+    }
+
+    /**
+     * @brief Loads a SymCoordTable stored as three consecutive sections
+     */
+    SymCoordTable symSections(const TableFile& file, size_t first, size_t size, size_t classes) {
+        return SymCoordTable(file.section<uint32_t>(first, size), file.section<uint32_t>(first + 1, classes),
+                             file.section<uint16_t>(first + 2, classes));
+    }
+
+    /**
+     * @brief Loads a mod-3 pruning table section
+     */
+    PruningTable mod3Section(const TableFile& file, size_t index, size_t entries) {
+        return PruningTable(file.section<uint8_t>(index, PruningTable::packedBytes(entries, PruningEncoding::Mod3)),
+                            entries, PruningEncoding::Mod3);
+    }
+}
+
+TwoPhaseTables::TwoPhaseTables(const TableBuildOptions& options)
+    : twist(CoordMoveTable::build(kTwistCount, twistCoord, g_allMoves)),
+      flip(CoordMoveTable::build(kFlipCount, flipCoord, g_allMoves)),
+      slice(CoordMoveTable::build(kSliceCount, sliceCoord, g_allMoves)),
+      cornerPerm(CoordMoveTable::build(kCornerPermCount, cornerPermCoord, g_phase2Moves)),
+      udEdgePerm(CoordMoveTable::build(kUDEdgePermCount, udEdgePermCoord, g_phase2Moves)),
+      slicePerm(CoordMoveTable::build(kSlicePermCount, slicePermCoord, g_phase2Moves)),
+      flipSliceSym(SymCoordTable::build(kFlipSliceCount, flipSliceCoord, g_allMoves)),
+      cornerPermSym(SymCoordTable::build(kCornerPermCount, cornerPermRawCoord, g_phase2Moves)),
+      twistConj(SymConjugationTable::build(kTwistCount, twistCoord, g_allMoves)),
+      udEdgePermConj(SymConjugationTable::build(kUDEdgePermCount, udEdgePermCoord, g_phase2Moves)),
+      flipSliceTwist(PruningTable::build(flipSliceSym.classCount() * kTwistCount, 0, [this](size_t index, auto&& visit) {
+          expandPhase1(*this, index, visit);
+      }, options).packed(PruningEncoding::Mod3)),
+      cornerEdge(PruningTable::build(cornerPermSym.classCount() * kUDEdgePermCount, 0, [this](size_t index, auto&& visit) {
+          expandPhase2(*this, index, visit);
+      }, options).packed(PruningEncoding::Mod3)),
+      cornerSlice(PruningTable::build(cornerPerm, slicePerm, g_phase2Moves, options)),
+      edgeSlice(PruningTable::build(udEdgePerm, slicePerm, g_phase2Moves, options)) {}
+
+TwoPhaseTables::TwoPhaseTables(const std::shared_ptr<const TableFile>& file)
+    : twist(file->section<uint16_t>(0, kTwistCount * kMoveCount)),
+      flip(file->section<uint16_t>(1, kFlipCount * kMoveCount)),
+      slice(file->section<uint16_t>(2, kSliceCount * kMoveCount)),
+      cornerPerm(file->section<uint16_t>(3, kCornerPermCount * kMoveCount)),
+      udEdgePerm(file->section<uint16_t>(4, kUDEdgePermCount * kMoveCount)),
+      slicePerm(file->section<uint16_t>(5, kSlicePermCount * kMoveCount)),
+      flipSliceSym(symSections(*file, 6, kFlipSliceCount, kFlipSliceClassCount)),
+      cornerPermSym(symSections(*file, 9, kCornerPermCount, kCornerPermClassCount)),
+      twistConj(file->section<uint16_t>(12, kTwistCount * kUDSymmetryCount)),
+      udEdgePermConj(file->section<uint16_t>(13, kUDEdgePermCount * kUDSymmetryCount)),
+      flipSliceTwist(mod3Section(*file, 14, kFlipSliceClassCount * kTwistCount)),
+      cornerEdge(mod3Section(*file, 15, kCornerPermClassCount * kUDEdgePermCount)),
+      cornerSlice(file->section<uint8_t>(16, kCornerPermCount * kSlicePermCount)),
+      edgeSlice(file->section<uint8_t>(17, kUDEdgePermCount * kSlicePermCount)) {}
+
+const TwoPhaseTables& TwoPhaseTables::instance() {
+    static const TwoPhaseTables tables =
+        loadOrBuildTables<TwoPhaseTables>(tableFilePath("twophase.tables"), TableBuildOptions{});
+    return tables;
+}
+
+void TwoPhaseTables::save(const std::string& path) const {
+    TableFileWriter out(kFileKind);
+    for (const CoordMoveTable* m : {&twist, &flip, &slice, &cornerPerm, &udEdgePerm, &slicePerm}) {
+        out.add(m->storage());
+    }
+    for (const SymCoordTable* c : {&flipSliceSym, &cornerPermSym}) {
+        out.add(c->classStorage());
+        out.add(c->representativeStorage());
+        out.add(c->symmetryStorage());
+    }
+    out.add(twistConj.storage());
+    out.add(udEdgePermConj.storage());
+    for (const PruningTable* p : {&flipSliceTwist, &cornerEdge, &cornerSlice, &edgeSlice}) out.add(p->storage());
+    out.commit(path);
+}
+
+size_t TwoPhaseTables::bytes() const {
+    return twist.bytes() + flip.bytes() + slice.bytes() + cornerPerm.bytes() + udEdgePerm.bytes() +
+           slicePerm.bytes() + flipSliceSym.bytes() + cornerPermSym.bytes() + twistConj.bytes() +
+           udEdgePermConj.bytes() + flipSliceTwist.bytes() + cornerEdge.bytes() + cornerSlice.bytes() +
+           edgeSlice.bytes();
+}
+
+namespace {
+    /// Longest path either phase can produce
+    constexpr int kMaxDepth = 32;
+
+    /// Nodes between two reads of the clock
+    constexpr uint64_t kClockInterval = 4096;
+
+    /**
+     * @brief Checks whether a move keeps the cube in G1
+     */
+    constexpr bool isPhase2Move(int move) {
+        return move < 6 || move % 3 == 2;
+    }
+
+    /**
+     * @brief State of one two-phase solve
+     *
+     * The search keeps the shortest solution found so far and goes on
+     * looking for strictly shorter ones until one reaches the target length.
+     * With a race, the bound is the shortest length any racer has found.
+     */
+    class TwoPhaseSearch {
+        const TwoPhaseTables& t;
+        const CubeState root;
+        const SearchLimits limits;
+        const SolutionCallback& onSolution;     ///< Told about every improvement; may be empty
+        TwoPhaseRace* race;                     ///< Shared bound and cancel flag; null when searching alone
+        const int target;                       ///< Stop at the first solution this short
+
+        std::array<uint8_t, kMaxDepth> path{};  ///< Moves of the current phase-1 + phase-2 path
+        std::array<uint8_t, kMaxDepth> best{};  ///< Shortest solution found so far
+        int bestLength = -1;                    ///< Length of best, or -1
+        int ownBound;                           ///< Longest solution still worth finding
+        uint64_t nodes = 0;
+        uint64_t nextClockCheck = kClockInterval;
+        bool timedOut = false;
+        bool stopped = false;                   ///< Target reached, timed out or cancelled
+
+    public:
+        TwoPhaseSearch(const TwoPhaseTables& tables, const CubeState& state, const SearchLimits& limits,
+                       const SolutionCallback& onSolution, TwoPhaseRace* race)
+            : t(tables), root(state), limits(limits), onSolution(onSolution), race(race),
+              target(limits.targetLength < 0 ? limits.maxLength : std::min(limits.targetLength, limits.maxLength)),
+              ownBound(limits.maxLength) {}
+
+        SolveResult run() {
+            const auto start = std::chrono::steady_clock::now();
+            const uint16_t tw = twistCoord(this->root);
+            const uint16_t fl = flipCoord(this->root);
+            const uint16_t sl = sliceCoord(this->root);
+            const int lower = t.flipSliceTwist.exactDistance(t.phase1Index(tw, fl, sl), [&](size_t index, auto&& visit) {
+                expandPhase1(t, index, visit);
+            });
+
+            for (int depth1 = lower; depth1 <= lengthBound() && !this->stopped; ++depth1) {
+                phase1(tw, fl, sl, lower, 0, depth1, kNoFace);
+            }
+
+            SolveResult result;
+            result.solved = this->bestLength >= 0;
+            result.timedOut = this->timedOut && !result.solved;
+            result.moves = solution();
+            result.stats.nodes = this->nodes;
+            result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+
+    private:
+        MoveSequence solution() const {
+            MoveSequence moves;
+            for (int i = 0; i < this->bestLength; ++i) moves.push_back(static_cast<RubiksCube::Move>(this->best[i]));
+            return moves;
+        }
+
+        /**
+         * @brief Returns the longest solution still worth finding
+         */
+        int lengthBound() const {
+            if (!this->race) return this->ownBound;
+            return std::min(this->ownBound, this->race->bestLength.load(std::memory_order_relaxed) - 1);
+        }
+
+        /**
+         * @brief Counts a node and reports whether the search must stop
+         */
+        bool mustStop() {
+            if (++this->nodes < this->nextClockCheck) return this->stopped;
+            this->nextClockCheck = this->nodes + kClockInterval;
+            this->timedOut = std::chrono::steady_clock::now() >= this->limits.deadline;
+            const bool cancelled = (this->race && this->race->cancel.load(std::memory_order_relaxed)) ||
+                                   (this->limits.cancel && this->limits.cancel->load(std::memory_order_relaxed));
+            this->stopped = this->stopped || this->timedOut || cancelled;
+            return this->stopped;
+        }
+
+        /**
+         * @brief Keeps the solution on the path and publishes it
+         */
+        void record(int length) {
+            this->best = this->path;
+            this->bestLength = length;
+            this->ownBound = length - 1;
+            if (this->onSolution) this->onSolution(solution());
+            if (this->race) {
+                int shortest = this->race->bestLength.load(std::memory_order_relaxed);
+                while (length < shortest &&
+                       !this->race->bestLength.compare_exchange_weak(shortest, length, std::memory_order_relaxed)) {}
+            }
+            if (length <= this->target) {
+                this->stopped = true;
+                if (this->race) this->race->cancel.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Searches phase-1 paths of exactly @p togo more moves
+         * @param dist Exact phase-1 distance of the node, carried along to read the mod-3 table
+         * @return true once the whole search must stop
+         */
+        bool phase1(uint16_t tw, uint16_t fl, uint16_t sl, int dist, int depth, int togo, int prevFace) {
+            if (togo == 0) {
+                // A phase-1 path ending in a G1 move has a shorter prefix that
+                // also reaches G1 and was tried at a smaller depth
+                if (depth > 0 && isPhase2Move(this->path[depth - 1])) return false;
+                return startPhase2(depth, prevFace);
+            }
+            struct Child {
+                uint16_t tw, fl, sl;
+                int move;
+                size_t index;  ///< Entry in flipSliceTwist
+            };
+            auto successor = [&](int m) {
+                const uint16_t ntw = t.twist(tw, (size_t)m);
+                const uint16_t nfl = t.flip(fl, (size_t)m);
+                const uint16_t nsl = t.slice(sl, (size_t)m);
+                return Child{ntw, nfl, nsl, m, t.phase1Index(ntw, nfl, nsl)};
+            };
+#if RUBIKS_PREFETCH
+            // Every child's pruning entry is requested before any is read
+            std::array<Child, kMoveCount> children;
+            int count = 0;
+            for (int m = 0; m < (int)kMoveCount; ++m) {
+                if (!canFollow(m / 3, prevFace)) continue;
+                children[count] = successor(m);
+                t.flipSliceTwist.prefetch(children[count++].index);
+            }
+            for (int i = 0; i < count; ++i) {
+                const Child& c = children[i];
+#else
+            for (int m = 0; m < (int)kMoveCount; ++m) {
+                if (!canFollow(m / 3, prevFace)) continue;
+                const Child c = successor(m);
+#endif
+                if (mustStop()) return true;
+                const int ndist = t.flipSliceTwist.distance(c.index, dist);
+                if (ndist >= togo) continue;
+                this->path[depth] = (uint8_t)c.move;
+                if (phase1(c.tw, c.fl, c.sl, ndist, depth + 1, togo - 1, c.move / 3)) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Tries to finish a phase-1 path of length @p depth1 with phase-2 moves
+         * @return true once the whole search must stop
+         */
+        bool startPhase2(int depth1, int prevFace) {
+            const int budget = lengthBound() - depth1;
+            if (budget < 0) return false;
+            CubeState s = this->root;
+            for (int i = 0; i < depth1; ++i) s.applyMove(static_cast<RubiksCube::Move>(this->path[i]));
+
+            const uint16_t cp = cornerPermCoord(s);
+            const uint16_t ep = udEdgePermCoord(s);
+            const uint16_t sp = slicePermCoord(s);
+            const int dist = t.cornerEdge.exactDistance(t.phase2Index(cp, ep), [&](size_t index, auto&& visit) {
+                expandPhase2(t, index, visit);
+            });
+            const int lower = std::max({dist, (int)t.cornerSlice[cp * kSlicePermCount + sp],
+                                        (int)t.edgeSlice[ep * kSlicePermCount + sp]});
+            for (int depth2 = lower; depth2 <= budget; ++depth2) {
+                if (phase2(cp, ep, sp, dist, depth1, depth2, prevFace)) {
+                    // Depths grow, so this is the shortest finish of this phase-1 path
+                    record(depth1 + depth2);
+                    return this->stopped;
+                }
+                if (this->stopped) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Searches phase-2 paths of exactly @p togo more moves
+         * @param dist Exact cornerEdge distance of the node
+         * @return true if a solution is on the path
+         */
+        bool phase2(uint16_t cp, uint16_t ep, uint16_t sp, int dist, int depth, int togo, int prevFace) {
+            if (togo == 0) return cp == 0 && ep == 0 && sp == 0;
+            for (RubiksCube::Move move : g_phase2Moves) {
+                const int m = static_cast<int>(move);
+                const int face = m / 3;
+                if (!canFollow(face, prevFace)) continue;
+                if (mustStop()) return false;
+                const uint16_t ncp = t.cornerPerm(cp, (size_t)m);
+                const uint16_t nep = t.udEdgePerm(ep, (size_t)m);
+                const uint16_t nsp = t.slicePerm(sp, (size_t)m);
+                const int ndist = t.cornerEdge.distance(t.phase2Index(ncp, nep), dist);
+                if (ndist >= togo) continue;
+                if (std::max(t.cornerSlice[ncp * kSlicePermCount + nsp], t.edgeSlice[nep * kSlicePermCount + nsp]) >= togo) {
+                    continue;
+                }
+                this->path[depth] = (uint8_t)m;
+                if (phase2(ncp, nep, nsp, ndist, depth + 1, togo - 1, face)) return true;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief Maps a solution of a conjugated, possibly inverted, state back to the original
+     * @param moves Solution of the variant
+     * @param unconjugate Move table undoing the conjugation, or null for none
+     * @param inverted Whether the variant is the inverse state
+     */
+    MoveSequence mapBack(const MoveSequence& moves, const std::array<uint8_t, kMoveCount>* unconjugate,
+                         bool inverted) {
+        MoveSequence r;
+        for (size_t i = 0; i < moves.size(); ++i) {
+            const size_t m = static_cast<size_t>(moves[i]);
+            r.push_back(static_cast<RubiksCube::Move>(unconjugate ? (*unconjugate)[m] : m));
+        }
+        return inverted ? r.inverse() : r;
+    }
+}
+
+SolveResult solveTwoPhase(const CubeState& state, const SearchLimits& limits, const SolutionCallback& onSolution,
+                          TwoPhaseRace* race, const TwoPhaseTables& tables) {
+    SearchLimits bounded = limits;
+    bounded.maxLength = std::clamp(limits.maxLength, 0, kMaxDepth);
+    return TwoPhaseSearch(tables, state, bounded, onSolution, race).run();
+}
+
+SolveResult solveTwoPhaseAllOrientations(const CubeState& state, const SearchLimits& limits,
+                                         const SolutionCallback& onSolution, const TwoPhaseTables& tables) {
+    const auto start = std::chrono::steady_clock::now();
+
+    // A solution M of S^-1 X S solves X as S M S^-1, one conjugated move at a
+    // time: rotating by S uses the inverse rotation's table and vice versa
+    const MoveDef rotations[3] = {identityMove(), g_urfRotation, inverseMove(g_urfRotation)};
+    const std::array<uint8_t, kMoveCount>* unconjugate[3] = {
+        nullptr, &g_urfInverseConjugateMove, &g_urfConjugateMove
+    };
+
+    TwoPhaseRace race;
+    // Two racers can find solutions of equal length at once; pass on only
+    // the strictly shorter ones, one at a time
+    std::mutex reportLock;
+    size_t reported = SIZE_MAX;
+
+    std::array<SolveResult, kTwoPhaseVariants> results;
+    std::vector<std::thread> threads;
+    for (int v = 0; v < kTwoPhaseVariants; ++v) {
+        threads.emplace_back([&, v] {
+            const bool inverted = v >= 3;
+            const CubeState base = inverted ? state.inverse() : state;
+            SolutionCallback report;
+            if (onSolution) {
+                report = [&, v, inverted](const MoveSequence& moves) {
+                    std::lock_guard<std::mutex> guard(reportLock);
+                    if (moves.size() >= reported) return;
+                    reported = moves.size();
+                    onSolution(mapBack(moves, unconjugate[v % 3], inverted));
+                };
+            }
+            results[v] = solveTwoPhase(conjugate(base, rotations[v % 3]), limits, report, &race, tables);
+            results[v].moves = mapBack(results[v].moves, unconjugate[v % 3], inverted);
+        });
+    }
+    for (std::thread& th : threads) th.join();
+
+    SolveResult best;
+    best.timedOut = true;
+    for (const SolveResult& r : results) {
+        best.stats.nodes += r.stats.nodes;
+        best.timedOut = best.timedOut && r.timedOut;
+        if (r.solved && (!best.solved || r.moves.size() < best.moves.size())) {
+            best.solved = true;
+            best.moves = r.moves;
+        }
+    }
+    best.timedOut = best.timedOut && !best.solved;
+    best.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return best;
+}
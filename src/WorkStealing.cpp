@@ -0,0 +1,100 @@
+/**
+ * @file WorkStealing.cpp
+ * @brief Range-splitting work-stealing scheduler
+ */
+
+#include "../include/WorkStealing.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Remaining task indices [begin, end) owned by one worker
+     *
+     * The owner takes from the front and thieves split off the back, so the
+     * two only contend on the lock when a range is nearly empty.
+     */
+    struct alignas(64) TaskRange {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+
+        bool take(size_t& task) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if (this->begin == this->end) return false;
+            task = this->begin++;
+            return true;
+        }
+
+        size_t remaining() {
+            std::lock_guard<std::mutex> guard(this->lock);
+            return this->end - this->begin;
+        }
+    };
+
+    /**
+     * @brief Moves the upper half of the fullest other range to worker @p self
+     * @return false once every range is empty
+     */
+    bool steal(std::vector<std::unique_ptr<TaskRange>>& ranges, unsigned self) {
+        while (true) {
+            unsigned victim = self;
+            size_t most = 0;
+            for (unsigned w = 0; w < ranges.size(); ++w) {
+                if (w == self) continue;
+                const size_t left = ranges[w]->remaining();
+                if (left > most) {
+                    most = left;
+                    victim = w;
+                }
+            }
+            if (most == 0) return false;
+
+            size_t from = 0, to = 0;
+            {
+                std::lock_guard<std::mutex> guard(ranges[victim]->lock);
+                TaskRange& v = *ranges[victim];
+                if (v.begin == v.end) continue;  // Emptied meanwhile; pick another victim
+                const size_t half = (v.end - v.begin + 1) / 2;
+                from = v.end - half;
+                to = v.end;
+                v.end = from;
+            }
+            std::lock_guard<std::mutex> guard(ranges[self]->lock);
+            ranges[self]->begin = from;
+            ranges[self]->end = to;
+            return true;
+        }
+    }
+}
+
+void runWorkStealing(size_t count, unsigned workers, const std::function<void(size_t task, unsigned worker)>& fn) {
+    workers = (unsigned)std::max<size_t>(1, std::min<size_t>(workers, count));
+    if (workers == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i, 0);
+        return;
+    }
+
+    std::vector<std::unique_ptr<TaskRange>> ranges;
+    for (unsigned w = 0; w < workers; ++w) {
+        auto range = std::make_unique<TaskRange>();
+        range->begin = count * w / workers;
+        range->end = count * (w + 1) / workers;
+        ranges.push_back(std::move(range));
+    }
+
+    auto work = [&](unsigned self) {
+        size_t task = 0;
+        do {
+            while (ranges[self]->take(task)) fn(task, self);
+        } while (steal(ranges, self));
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned w = 1; w < workers; ++w) threads.emplace_back(work, w);
+    work(0);
+    for (std::thread& th : threads) th.join();
+}